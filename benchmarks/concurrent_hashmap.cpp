@@ -0,0 +1,110 @@
+// Throughput of ConcurrentHashMap against a HashMap protected by a single mutex, for a varying
+// number of threads and mix of reads and writes
+// $ g++ -O2 -std=c++17 -pthread -I../include concurrent_hashmap.cpp && ./a.out
+#include "concurrent_hashmap.hpp"
+#include "hashmap.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define KEY_RANGE 1000000
+#define OPERATIONS_PER_THREAD 500000
+#define MAX_THREADS 32
+
+// The baseline, a single lock around the whole table
+class LockedHashMap
+{
+    std::mutex mutex;
+    HashMap<int, int> map;
+
+  public:
+    std::optional<int> find(int key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return map.find(key);
+    }
+
+    void insert(int key, int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        map.insert(key, value);
+    }
+
+    void erase(int key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        map.erase(key);
+    }
+};
+
+// Runs OPERATIONS_PER_THREAD operations on each thread, read_percent of them are finds and the
+// rest are split between inserts and erases. Returns the throughput in million operations / second
+template <typename Map> double run(Map &map, int number_of_threads, int read_percent)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&map, t, read_percent]()
+            {
+                std::mt19937 mt(static_cast<unsigned>(t));
+                std::uniform_int_distribution<int> key_dist(0, KEY_RANGE - 1);
+                std::uniform_int_distribution<int> op_dist(0, 99);
+                long long found = 0;
+                for (int i = 0; i < OPERATIONS_PER_THREAD; i++)
+                {
+                    int key = key_dist(mt), op = op_dist(mt);
+                    if (op < read_percent)
+                        found += map.find(key).has_value();
+                    else if (op % 2)
+                        map.insert(key, i);
+                    else
+                        map.erase(key);
+                }
+                // Keep the finds from being optimized away
+                if (found < 0)
+                    std::cout << found;
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(number_of_threads) * OPERATIONS_PER_THREAD / elapsed / 1e6;
+}
+
+template <typename Map> void prefill(Map &map)
+{
+    for (int i = 0; i < KEY_RANGE; i += 2)
+        map.insert(i, i);
+}
+
+int main()
+{
+    std::cout << "| " << std::setw(8) << "Threads" << " | " << std::setw(7) << "Reads %" << " | "
+              << std::setw(18) << "Mutex (Mops/s)" << " | " << std::setw(18)
+              << "Sharded (Mops/s)" << " |" << std::endl;
+    std::cout << "|----------|---------|--------------------|--------------------|" << std::endl;
+    for (int read_percent : {50, 90, 99})
+    {
+        for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+        {
+            LockedHashMap locked;
+            ConcurrentHashMap<int, int> sharded;
+            prefill(locked);
+            prefill(sharded);
+            double locked_throughput = run(locked, threads, read_percent);
+            double sharded_throughput = run(sharded, threads, read_percent);
+            std::cout << "| " << std::setw(8) << threads << " | " << std::setw(7) << read_percent
+                      << " | " << std::setw(18) << std::fixed << std::setprecision(2)
+                      << locked_throughput << " | " << std::setw(18) << sharded_throughput << " |"
+                      << std::endl;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Compares HashMap::find_batch against a loop of HashMap::find, for tables which fit in the L2
+// cache up to tables which are four times larger than the last level cache
+// $ g++ -O2 -std=c++17 -I../include hashmap_batch.cpp && ./a.out
+#include "hashmap.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+#define NUMBER_OF_LOOKUPS (1 << 22)
+#define LOOKUP_BATCH 1024
+
+static size_t cache_size(int name, size_t fallback)
+{
+    long size = sysconf(name);
+    return size > 0 ? static_cast<size_t>(size) : fallback;
+}
+
+template <typename F> static double nanoseconds_per_lookup(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double elapsed =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / NUMBER_OF_LOOKUPS;
+}
+
+int main()
+{
+    size_t l2 = cache_size(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+    size_t llc = cache_size(_SC_LEVEL3_CACHE_SIZE, 32 << 20);
+    std::cout << "L2: " << (l2 >> 10) << " KiB, LLC: " << (llc >> 10) << " KiB" << std::endl;
+    std::cout << "| " << std::setw(12) << "Table size" << " | " << std::setw(10) << "Keys" << " | "
+              << std::setw(14) << "find (ns/op)" << " | " << std::setw(20)
+              << "find_batch (ns/op)" << " |" << std::endl;
+    std::cout << "|--------------|------------|----------------|----------------------|"
+              << std::endl;
+
+    std::mt19937_64 mt(42);
+    // Each slot of HashMap<uint64_t, uint64_t> is about 32 bytes, and the table is kept between
+    // 35% and 70% full
+    const size_t bytes_per_key = 32 * 2;
+    for (size_t bytes = l2 / 2; bytes <= 4 * llc; bytes *= 2)
+    {
+        size_t n = bytes / bytes_per_key;
+        HashMap<uint64_t, uint64_t> h;
+        std::vector<uint64_t> keys(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            keys[i] = mt();
+            h.insert(keys[i], i);
+        }
+        std::vector<uint64_t> lookups(NUMBER_OF_LOOKUPS);
+        std::uniform_int_distribution<size_t> dist(0, n - 1);
+        for (auto &key : lookups)
+            key = keys[dist(mt)];
+
+        uint64_t sum = 0;
+        double scalar = nanoseconds_per_lookup(
+            [&]()
+            {
+                for (auto key : lookups)
+                    sum += *h.find(key);
+            });
+        double batched = nanoseconds_per_lookup(
+            [&]()
+            {
+                std::vector<uint64_t *> out(LOOKUP_BATCH);
+                for (size_t i = 0; i < lookups.size(); i += LOOKUP_BATCH)
+                {
+                    h.find_batch(&lookups[i], LOOKUP_BATCH, out.data());
+                    for (auto value : out)
+                        sum -= *value;
+                }
+            });
+        if (sum != 0)
+            std::cerr << "Verification failed" << std::endl;
+        std::cout << "| " << std::setw(8) << (bytes >> 10) << " KiB" << " | " << std::setw(10) << n
+                  << " | " << std::setw(14) << std::fixed << std::setprecision(2) << scalar << " | "
+                  << std::setw(20) << batched << " |" << std::endl;
+    }
+
+    // Probe statistics of a table with one million random keys, after as many hits and misses
+    std::cout << std::endl;
+    HashMap<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, ModuloCapacity,
+            HashMapStats>
+        h;
+    std::vector<uint64_t> keys(1000000);
+    for (auto &key : keys)
+    {
+        key = mt();
+        h.insert(key, key);
+    }
+    for (auto key : keys)
+    {
+        h.find(key);
+        h.find(key + 1);
+    }
+    h.dump_stats();
+}
@@ -0,0 +1,94 @@
+// Throughput of LockFreeStack against a Stack protected by a single mutex, from 1 to 64 threads.
+// Each thread uses the stack as a shared pool of work: it pushes an item, then pops one
+// $ g++ -O2 -std=c++17 -pthread -I../include lock_free_stack.cpp && ./a.out
+#include "lock_free_stack.hpp"
+#include "stack.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define PREFILL 1000
+#define OPERATIONS_PER_THREAD 1000000
+#define MAX_THREADS 64
+
+// The baseline, a single lock around the whole stack
+class LockedStack
+{
+    std::mutex mutex;
+    Stack<int> stack;
+
+  public:
+    void push(int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stack.push(value);
+    }
+
+    bool try_pop(int &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stack.empty())
+            return false;
+        value = stack.top();
+        stack.pop();
+        return true;
+    }
+};
+
+// Runs OPERATIONS_PER_THREAD operations on each thread, half pushes and half pops. Returns the
+// throughput in million operations / second
+template <typename S> double run(S &stack, int number_of_threads)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&stack]()
+            {
+                int value, popped = 0;
+                for (int i = 0; i < OPERATIONS_PER_THREAD; i += 2)
+                {
+                    stack.push(i);
+                    if (stack.try_pop(value))
+                        popped ^= value;
+                }
+                // Keep the pops from being optimized away
+                if (popped == -1)
+                    std::cout << popped;
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(number_of_threads) * OPERATIONS_PER_THREAD / elapsed / 1e6;
+}
+
+template <typename S> void prefill(S &stack)
+{
+    for (int i = 0; i < PREFILL; i++)
+        stack.push(i);
+}
+
+int main()
+{
+    std::cout << "| " << std::setw(8) << "Threads" << " | " << std::setw(18) << "Mutex (Mops/s)"
+              << " | " << std::setw(21) << "Lock-free (Mops/s)" << " |" << std::endl;
+    std::cout << "|----------|--------------------|-----------------------|" << std::endl;
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        LockedStack locked;
+        LockFreeStack<int> lock_free;
+        prefill(locked);
+        prefill(lock_free);
+        double locked_throughput = run(locked, threads);
+        double lock_free_throughput = run(lock_free, threads);
+        std::cout << "| " << std::setw(8) << threads << " | " << std::setw(18) << std::fixed
+                  << std::setprecision(2) << locked_throughput << " | " << std::setw(21)
+                  << lock_free_throughput << " |" << std::endl;
+    }
+}
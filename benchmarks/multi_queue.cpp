@@ -0,0 +1,97 @@
+// Throughput of MultiQueue against a PriorityQueue protected by a single mutex, from 1 to 64
+// threads. Each thread alternates pushes and pops on a queue which starts with PREFILL elements
+// $ g++ -O2 -std=c++17 -pthread -I../include multi_queue.cpp && ./a.out
+#include "multi_queue.hpp"
+#include "priority_queue.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define PREFILL 1000000
+#define OPERATIONS_PER_THREAD 500000
+#define MAX_THREADS 64
+
+// The baseline, a single lock around the whole heap
+class LockedPriorityQueue
+{
+    std::mutex mutex;
+    PriorityQueue<unsigned> queue;
+
+  public:
+    void push(unsigned value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(value);
+    }
+
+    bool try_pop(unsigned &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+            return false;
+        value = queue.top();
+        queue.pop();
+        return true;
+    }
+};
+
+// Runs OPERATIONS_PER_THREAD operations on each thread, half pushes of random values and half
+// pops. Returns the throughput in million operations / second
+template <typename Queue> double run(Queue &queue, int number_of_threads)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&queue, t]()
+            {
+                std::mt19937 mt(static_cast<unsigned>(t));
+                unsigned value, popped = 0;
+                for (int i = 0; i < OPERATIONS_PER_THREAD; i += 2)
+                {
+                    queue.push(mt());
+                    if (queue.try_pop(value))
+                        popped ^= value;
+                }
+                // Keep the pops from being optimized away
+                if (popped == 1)
+                    std::cout << popped;
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(number_of_threads) * OPERATIONS_PER_THREAD / elapsed / 1e6;
+}
+
+template <typename Queue> void prefill(Queue &queue)
+{
+    std::mt19937 mt(12345);
+    for (int i = 0; i < PREFILL; i++)
+        queue.push(mt());
+}
+
+int main()
+{
+    std::cout << "| " << std::setw(8) << "Threads" << " | " << std::setw(18) << "Mutex (Mops/s)"
+              << " | " << std::setw(22) << "MultiQueue (Mops/s)" << " |" << std::endl;
+    std::cout << "|----------|--------------------|------------------------|" << std::endl;
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        LockedPriorityQueue locked;
+        MultiQueue<unsigned> relaxed(static_cast<size_t>(threads));
+        prefill(locked);
+        prefill(relaxed);
+        double locked_throughput = run(locked, threads);
+        double relaxed_throughput = run(relaxed, threads);
+        std::cout << "| " << std::setw(8) << threads << " | " << std::setw(18) << std::fixed
+                  << std::setprecision(2) << locked_throughput << " | " << std::setw(22)
+                  << relaxed_throughput << " |" << std::endl;
+    }
+}
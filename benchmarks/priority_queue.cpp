@@ -0,0 +1,69 @@
+// Compares push and pop throughput of PriorityQueue with 2, 4 and 8 children per node against
+// std::priority_queue, for a heap of ten million random 64 bit integers
+// $ g++ -O2 -std=c++17 -I../include priority_queue.cpp && ./a.out
+#include "priority_queue.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define NUMBER_OF_ELEMENTS 10000000
+
+template <typename F> static double nanoseconds_per_element(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double elapsed =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / NUMBER_OF_ELEMENTS;
+}
+
+template <typename PQ>
+static void run(const std::string &name, const std::vector<uint64_t> &values)
+{
+    PQ pq;
+    double push = nanoseconds_per_element(
+        [&]()
+        {
+            for (auto value : values)
+                pq.push(value);
+        });
+    uint64_t previous = UINT64_MAX;
+    bool sorted = true;
+    double pop = nanoseconds_per_element(
+        [&]()
+        {
+            while (!pq.empty())
+            {
+                sorted &= pq.top() <= previous;
+                previous = pq.top();
+                pq.pop();
+            }
+        });
+    if (!sorted)
+        std::cerr << name << ": elements were not popped in order" << std::endl;
+    std::cout << "| " << std::setw(24) << name << " | " << std::setw(14) << std::fixed
+              << std::setprecision(2) << push << " | " << std::setw(13) << pop << " |"
+              << std::endl;
+}
+
+int main()
+{
+    std::mt19937_64 mt(42);
+    std::vector<uint64_t> values(NUMBER_OF_ELEMENTS);
+    for (auto &value : values)
+        value = mt();
+
+    std::cout << "| " << std::setw(24) << "Heap" << " | " << std::setw(14) << "push (ns/op)"
+              << " | " << std::setw(13) << "pop (ns/op)" << " |" << std::endl;
+    std::cout << "|--------------------------|----------------|---------------|" << std::endl;
+    run<std::priority_queue<uint64_t>>("std::priority_queue", values);
+    using Container = std::vector<uint64_t, CacheAlignedAllocator<uint64_t>>;
+    run<PriorityQueue<uint64_t, Container, std::less<uint64_t>, 2>>("PriorityQueue<2>", values);
+    run<PriorityQueue<uint64_t, Container, std::less<uint64_t>, 4>>("PriorityQueue<4>", values);
+    run<PriorityQueue<uint64_t, Container, std::less<uint64_t>, 8>>("PriorityQueue<8>", values);
+}
@@ -0,0 +1,181 @@
+#ifndef A_BLOOM_FILTER_H
+#define A_BLOOM_FILTER_H
+#include "hash.hpp"
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * BloomFilter
+ * ===========
+ * A blocked Bloom filter (split block Bloom filter, as in Apache Parquet), which answers "maybe
+ * present" or "definitely not present" for a set of keys
+ * Design choices
+ * 1) The bits are split into blocks of 256 bits, aligned so that a block never crosses a cache
+ * line. A key selects one block from its hash, and sets one bit in each of the 8 32-bit words of
+ * that block, so insert and may_contain touch a single cache line
+ * 2) The 8 bit positions are computed from 32 bits of the hash with 8 multiplications by odd
+ * constants. With AVX2 the whole block is computed and tested with a few vector instructions,
+ * otherwise a plain loop over the 8 words is used
+ * 3) The number of blocks is chosen from the expected number of keys and the bits per key. With
+ * 10 bits per key, about 1% of the keys which were not inserted are reported as maybe present.
+ * Keys can not be removed
+ * 4) save(stream) writes a small header and the blocks, and load(stream) reads them back, so a
+ * filter can be built on one machine and used on another. Both sides must use a Hash which gives
+ * the same results (std::hash is not guaranteed to), and the same byte order
+ */
+template <typename Key, typename Hash = std::hash<Key>> class BloomFilter
+{
+  private:
+    struct alignas(32) Block
+    {
+        uint32_t words[8];
+    };
+
+    // Odd constants, the bit of word i is given by the top 5 bits of (hash * SALT[i])
+    alignas(32) static constexpr uint32_t SALT[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                                     0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                                     0x9efc4947U, 0x5c6bfb31U};
+
+    // Header of the stream written by save
+    struct Header
+    {
+        static constexpr uint64_t MAGIC = 0x544c464d4f4f4c42ULL; // "BLOOMFLT"
+        static constexpr uint32_t VERSION = 1;
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t block_size;
+        uint64_t number_of_blocks;
+    };
+
+    Hash hasher_;
+    std::vector<Block> blocks;
+
+    // Mixed, so that weak hashes such as the identity std::hash<int> spread over all the blocks
+    // and bits
+    auto hash_of(const Key &key) const -> uint64_t
+    {
+        return mix64(static_cast<uint64_t>(hasher_(key)));
+    }
+
+    // The upper 32 bits of the hash select the block, without a division
+    auto block_of(uint64_t hash) const -> size_t
+    {
+        return static_cast<size_t>(((hash >> 32) * blocks.size()) >> 32);
+    }
+
+#if defined(__AVX2__)
+    static auto make_mask(uint32_t hash) -> __m256i
+    {
+        __m256i salt = _mm256_load_si256(reinterpret_cast<const __m256i *>(SALT));
+        __m256i product = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)), salt);
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(product, 27));
+    }
+#endif
+
+    static auto bit_of(uint32_t hash, size_t word) -> uint32_t
+    {
+        return uint32_t(1) << ((hash * SALT[word]) >> 27);
+    }
+
+  public:
+    using key_type = Key;
+    using hasher = Hash;
+    static constexpr size_t BLOCK_BITS = 256;
+    static constexpr double DEFAULT_BITS_PER_KEY = 10;
+
+    // Sizes the filter for expected_keys keys, with bits_per_key bits for each of them
+    explicit BloomFilter(size_t expected_keys = 0, double bits_per_key = DEFAULT_BITS_PER_KEY)
+    {
+        if (bits_per_key <= 0)
+            throw std::logic_error("Invalid number of bits per key, it should be positive");
+        auto bits = static_cast<double>(expected_keys) * bits_per_key;
+        auto number_of_blocks = static_cast<size_t>(bits / BLOCK_BITS) + 1;
+        blocks.assign(number_of_blocks, Block());
+    }
+
+    auto insert(const Key &key) -> void { insert_hash(hash_of(key)); }
+
+    // Returns false if the key was never inserted, and true if it may have been
+    auto may_contain(const Key &key) const -> bool { return may_contain_hash(hash_of(key)); }
+
+    // Same as insert and may_contain, for a hash which is already well mixed
+    auto insert_hash(uint64_t hash) -> void
+    {
+        Block &block = blocks[block_of(hash)];
+#if defined(__AVX2__)
+        auto *words = reinterpret_cast<__m256i *>(block.words);
+        _mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words),
+                                                  make_mask(static_cast<uint32_t>(hash))));
+#else
+        for (size_t i = 0; i < 8; ++i)
+            block.words[i] |= bit_of(static_cast<uint32_t>(hash), i);
+#endif
+    }
+
+    auto may_contain_hash(uint64_t hash) const -> bool
+    {
+        const Block &block = blocks[block_of(hash)];
+#if defined(__AVX2__)
+        // testc is 1 if every bit of the mask is set in the block
+        __m256i words = _mm256_load_si256(reinterpret_cast<const __m256i *>(block.words));
+        return _mm256_testc_si256(words, make_mask(static_cast<uint32_t>(hash)));
+#else
+        for (size_t i = 0; i < 8; ++i)
+            if (!(block.words[i] & bit_of(static_cast<uint32_t>(hash), i)))
+                return false;
+        return true;
+#endif
+    }
+
+    auto clear() -> void { std::fill(blocks.begin(), blocks.end(), Block()); }
+
+    auto number_of_blocks() const -> size_t { return blocks.size(); }
+
+    auto size_in_bytes() const -> size_t { return blocks.size() * sizeof(Block); }
+
+    // Writes the filter to out, in the format read by load
+    auto save(std::ostream &out) const -> void
+    {
+        Header header = {};
+        header.magic = Header::MAGIC;
+        header.version = Header::VERSION;
+        header.block_size = sizeof(Block);
+        header.number_of_blocks = blocks.size();
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(blocks.data()),
+                  static_cast<std::streamsize>(size_in_bytes()));
+        if (!out)
+            throw std::runtime_error("Could not write the Bloom filter");
+    }
+
+    // Reads a filter which was written by save
+    static auto load(std::istream &in) -> BloomFilter
+    {
+        Header header;
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            header.magic != Header::MAGIC)
+            throw std::runtime_error("Not a Bloom filter");
+        if (header.version != Header::VERSION || header.block_size != sizeof(Block) ||
+            header.number_of_blocks == 0)
+            throw std::runtime_error("Unsupported Bloom filter format");
+
+        BloomFilter filter;
+        filter.blocks.resize(static_cast<size_t>(header.number_of_blocks));
+        if (!in.read(reinterpret_cast<char *>(filter.blocks.data()),
+                     static_cast<std::streamsize>(filter.size_in_bytes())))
+            throw std::runtime_error("The Bloom filter is truncated");
+        return filter;
+    }
+};
+
+#endif // A_BLOOM_FILTER_H
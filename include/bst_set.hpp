@@ -1,12 +1,19 @@
 #pragma once
+#include "node_allocator.hpp"
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <stdint.h>
+#include <type_traits>
 
 // Some differences w.r.t standard library set
 // 1. Decrementing begin() results in end() and not undefined behavior
+// 2. Nodes are allocated with Allocator, rebound to the node type. With a PoolAllocator or an
+// ArenaAllocator, the nodes are next to each other in memory, and clear() with an arena does not
+// visit the nodes when Key needs no destructor
 
-template <typename Key, class Compare = std::less<Key>> class BSTSet
+template <typename Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+class BSTSet
 {
   private:
     class Node
@@ -22,10 +29,14 @@ template <typename Key, class Compare = std::less<Key>> class BSTSet
         Node(const Key &value) : right(nullptr), left(nullptr), parent(nullptr), value(value) {}
     };
 
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeTraits;
+
     Node *root;
     Node *leftmost;
     Node *rightmost;
     size_t sz;
+    NodeAllocator alloc;
 
     void clear_(Node *n)
     {
@@ -33,14 +44,26 @@ template <typename Key, class Compare = std::less<Key>> class BSTSet
         {
             clear_(n->left);
             clear_(n->right);
-            delete n;
+            n->~Node();
+            NodeTraits::deallocate(alloc, n, 1);
         }
     }
 
     Node *get_node(const Key &t)
     {
+        Node *node = NodeTraits::allocate(alloc, 1);
+        // Returns the node to the allocator if copying the key throws, as new Node would
+        try
+        {
+            new (node) Node(t);
+        }
+        catch (...)
+        {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
         sz++;
-        return new Node(t);
+        return node;
     }
 
 
@@ -51,6 +74,7 @@ template <typename Key, class Compare = std::less<Key>> class BSTSet
     typedef ptrdiff_t difference_type;
     typedef Compare key_compare;
     typedef Compare value_compare;
+    typedef Allocator allocator_type;
     typedef Key &reference;
     typedef const Key &const_reference;
     class Iterator;
@@ -201,6 +225,13 @@ template <typename Key, class Compare = std::less<Key>> class BSTSet
 
     BSTSet() : root(nullptr), leftmost(nullptr), rightmost(nullptr), sz(0) {}
 
+    explicit BSTSet(const Allocator &allocator)
+        : root(nullptr), leftmost(nullptr), rightmost(nullptr), sz(0), alloc(allocator)
+    {
+    }
+
+    allocator_type get_allocator() const { return allocator_type(alloc); }
+
     size_t size() { return sz; }
 
     std::pair<Iterator, bool> insert(const Key &t)
@@ -261,8 +292,15 @@ template <typename Key, class Compare = std::less<Key>> class BSTSet
     void clear()
     {
         // TODO: Make an iterative clear function instead
-        clear_(root);
+        if constexpr (!is_monotonic_allocator<NodeAllocator>::value ||
+                      !std::is_trivially_destructible<Key>::value)
+            clear_(root);
+        if constexpr (is_monotonic_allocator<NodeAllocator>::value)
+            alloc.clear_if_unshared();
         root = nullptr;
+        leftmost = nullptr;
+        rightmost = nullptr;
+        sz = 0;
     }
 
     iterator begin() const { return Iterator(leftmost, &rightmost); }
@@ -0,0 +1,137 @@
+#ifndef A_CONCURRENT_HASHMAP_H
+#define A_CONCURRENT_HASHMAP_H
+#include "hashmap.hpp"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <stdint.h>
+
+/*
+ * ConcurrentHashMap
+ * =================
+ * A thread safe hash table, built on top of HashMap
+ * Design choices
+ * 1) The table is split into a number of shards (a power of two), each shard is an independent
+ * HashMap with its own reader/writer lock. Operations on keys in different shards never wait for
+ * each other, and lookups in the same shard run in parallel
+ * 2) The shard of a key is selected from the upper bits of its (mixed) hash, the HashMap within
+ * the shard uses the hash in the usual way
+ * 3) find() returns a copy of the value, since a reference would not be protected by the lock once
+ * find() returns. To modify a value in place, use upsert(Key, Fn), fn is called with the shard
+ * locked
+ * 4) size() locks every shard one after the other, so the result is only a snapshot when other
+ * threads are modifying the table
+ * 5) Each shard is aligned to a cache line so that the locks of different shards do not share a
+ * cache line
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap
+{
+  private:
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex;
+        HashMap<Key, Value, Hash, KeyEqual> map;
+    };
+
+    Hash hasher_;
+    size_t number_of_shards, shard_shift;
+    std::unique_ptr<Shard[]> shards;
+
+    auto shard_for(const Key &key) const -> Shard &
+    {
+        // Fibonacci hashing, the upper bits of the product depend on all bits of the hash
+        uint64_t h = static_cast<uint64_t>(hasher_(key)) * 0x9E3779B97F4A7C15ULL;
+        if (shard_shift == 64)
+            return shards[0];
+        return shards[static_cast<size_t>(h >> shard_shift)];
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    static constexpr size_t DEFAULT_NUMBER_OF_SHARDS = 64;
+
+    // The number of shards is rounded up to a power of two
+    explicit ConcurrentHashMap(size_t shard_count = DEFAULT_NUMBER_OF_SHARDS)
+        : number_of_shards(1), shard_shift(64)
+    {
+        if (shard_count == 0)
+            throw std::logic_error("Number of shards should be greater than 0");
+        while (number_of_shards < shard_count)
+        {
+            number_of_shards *= 2;
+            --shard_shift;
+        }
+        shards = std::make_unique<Shard[]>(number_of_shards);
+    }
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        const Shard &shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.map.find(key);
+    }
+
+    auto contains(const Key &key) const -> bool
+    {
+        const Shard &shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.map.contains(key);
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.map.insert(key, value);
+    }
+
+    auto erase(const Key &key) -> void
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.map.erase(key);
+    }
+
+    // Calls fn with a reference to the value of the key while holding the lock of its shard. fn
+    // should be short, and must not access this table
+    template <typename Fn> auto upsert(const Key &key, Fn fn) -> void
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.map.upsert(key, fn);
+    }
+
+    auto size() const -> size_type
+    {
+        size_type total = 0;
+        for (size_t i = 0; i < number_of_shards; ++i)
+        {
+            std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+            total += shards[i].map.size();
+        }
+        return total;
+    }
+
+    auto empty() const -> bool { return size() == 0; }
+
+    auto clear() -> void
+    {
+        for (size_t i = 0; i < number_of_shards; ++i)
+        {
+            std::unique_lock<std::shared_mutex> lock(shards[i].mutex);
+            shards[i].map.clear();
+        }
+    }
+
+    auto shard_count() const -> size_type { return number_of_shards; }
+};
+
+#endif // A_CONCURRENT_HASHMAP_H
@@ -0,0 +1,499 @@
+#ifndef A_CUCKOO_HASHMAP_H
+#define A_CUCKOO_HASHMAP_H
+#include "hash.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * CuckooHashMap
+ * =============
+ * A bucketized cuckoo hash table, with a bounded number of memory accesses per lookup
+ * Design choices
+ * 1) Every key has two candidate buckets, chosen by two hash functions (the lower and the upper
+ * half of a 64 bit mixed hash). A key is always stored in one of its two buckets, or in the stash,
+ * so a lookup reads at most two buckets
+ * 2) A bucket holds SlotsPerBucket (4 or 8) slots, and is aligned to a cache line. A lookup touches
+ * at most 2 * BUCKET_CACHE_LINES cache lines, plus the stash when it is not empty. With integer
+ * keys, a bucket holds only the keys and values, and an empty slot holds EMPTY_KEY (the largest
+ * key, whose value is kept apart from the buckets). 4 slots of 8 byte keys and values, or 8 slots
+ * of 4 byte keys and values, fill exactly one line, so a lookup touches at most two. Other keys
+ * have a 1 byte tag per slot, which holds a few bits of the hash of the key, and keys are compared
+ * only on a tag match. Their buckets span one line when the tags, keys and values of the slots
+ * take 64 bytes or less
+ * 3) When both buckets of a new key are full, a breadth first search looks for the shortest chain
+ * of keys which can each be moved to their other bucket, ending at a bucket with a free slot. The
+ * keys along the chain are moved, which frees a slot in one of the buckets of the new key
+ * 4) If the search fails, the key is placed in a small stash which every lookup checks when it is
+ * not empty. The table grows only when the stash is also full, which lets it reach load factors
+ * of 0.95 and more. An insert throws std::length_error if the table still has no room for the key
+ * after MAX_GROWS_PER_INSERT doublings, as happens when too many keys share the same two buckets
+ * 5) Supports the same operations as HashMap, find, insert, erase, contains, size, clear,
+ * load_factor. Key and Value have to be DefaultConstructible
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>, size_t SlotsPerBucket = 4>
+class CuckooHashMap
+{
+    static_assert(SlotsPerBucket == 4 || SlotsPerBucket == 8,
+                  "A bucket should have 4 or 8 slots");
+
+  private:
+    static constexpr uint8_t EMPTY = 0;
+    // Integer keys are compared directly, and need no tags
+    static constexpr bool TAGGED =
+        !(std::is_integral<Key>::value && std::is_same<KeyEqual, std::equal_to<Key>>::value);
+
+    static auto empty_key() -> Key { return std::numeric_limits<Key>::max(); }
+
+    struct alignas(64) TaggedBucket
+    {
+        uint8_t tags[SlotsPerBucket] = {};
+        Key keys[SlotsPerBucket];
+        Value values[SlotsPerBucket];
+
+        auto occupied(size_t i) const -> bool { return tags[i] != EMPTY; }
+
+        auto tag_at(size_t i) const -> uint8_t { return tags[i]; }
+
+        auto tag_matches(size_t i, uint8_t tag) const -> bool { return tags[i] == tag; }
+
+        auto set_tag(size_t i, uint8_t tag) -> void { tags[i] = tag; }
+
+        auto clear(size_t i) -> void
+        {
+            tags[i] = EMPTY;
+            keys[i] = Key();
+            values[i] = Value();
+        }
+    };
+
+    struct alignas(64) KeyedBucket
+    {
+        Key keys[SlotsPerBucket];
+        Value values[SlotsPerBucket];
+
+        KeyedBucket()
+        {
+            for (size_t i = 0; i < SlotsPerBucket; ++i)
+                keys[i] = empty_key();
+        }
+
+        auto occupied(size_t i) const -> bool { return keys[i] != empty_key(); }
+
+        auto tag_at(size_t) const -> uint8_t { return EMPTY; }
+
+        // An empty slot never matches, since empty_key() is not looked up in the buckets
+        auto tag_matches(size_t, uint8_t) const -> bool { return true; }
+
+        auto set_tag(size_t, uint8_t) -> void {}
+
+        auto clear(size_t i) -> void
+        {
+            keys[i] = empty_key();
+            values[i] = Value();
+        }
+    };
+
+    struct Bucket : std::conditional_t<TAGGED, TaggedBucket, KeyedBucket>
+    {
+        auto free_slot() const -> size_t
+        {
+            for (size_t i = 0; i < SlotsPerBucket; ++i)
+                if (!this->occupied(i))
+                    return i;
+            return SlotsPerBucket;
+        }
+    };
+
+    struct Entry
+    {
+        Key k;
+        Value v;
+    };
+
+    // A node of the breadth first search. The bucket was reached by moving the key in slot of the
+    // bucket of the parent node
+    struct Path
+    {
+        size_t bucket;
+        int parent;
+        size_t slot;
+    };
+
+    KeyEqual key_equal_;
+    Hash hasher_;
+    size_t sz, mask;
+    float max_load_factor_;
+
+    std::vector<Bucket> buckets;
+    std::vector<Entry> stash;
+    // The value of empty_key(), which cannot be stored in a KeyedBucket
+    std::optional<Value> empty_key_value;
+
+    auto is_empty_key(const Key &key) const -> bool
+    {
+        if constexpr (TAGGED)
+            return false;
+        else
+            return key == empty_key();
+    }
+
+    auto hash_of(const Key &key) const -> uint64_t
+    {
+        return mix64(static_cast<uint64_t>(hasher_(key)));
+    }
+
+    // The tag is never EMPTY
+    static auto tag_of(uint64_t hash) -> uint8_t
+    {
+        auto tag = static_cast<uint8_t>(hash >> 56);
+        return tag == EMPTY ? 1 : tag;
+    }
+
+    auto first_bucket(uint64_t hash) const -> size_t { return static_cast<size_t>(hash) & mask; }
+
+    auto second_bucket(uint64_t hash) const -> size_t
+    {
+        return static_cast<size_t>(hash >> 32) & mask;
+    }
+
+    // Returns the other candidate bucket of a key which is in bucket
+    auto alternate(uint64_t hash, size_t bucket) const -> size_t
+    {
+        auto first = first_bucket(hash);
+        return bucket == first ? second_bucket(hash) : first;
+    }
+
+    // Returns the slot of the key within the bucket, or SlotsPerBucket
+    auto find_in_bucket(size_t bucket, const Key &key, uint8_t tag) const -> size_t
+    {
+        const Bucket &b = buckets[bucket];
+        for (size_t i = 0; i < SlotsPerBucket; ++i)
+            if (b.tag_matches(i, tag) && key_equal_(b.keys[i], key))
+                return i;
+        return SlotsPerBucket;
+    }
+
+    // Locates the key, returning pointer to its value, or nullptr
+    auto lookup(const Key &key) const -> const Value *
+    {
+        if (sz == 0)
+            return nullptr;
+        if (is_empty_key(key))
+            return empty_key_value ? &*empty_key_value : nullptr;
+        auto hash = hash_of(key);
+        auto tag = tag_of(hash);
+        auto b1 = first_bucket(hash);
+        auto slot = find_in_bucket(b1, key, tag);
+        if (slot != SlotsPerBucket)
+            return &buckets[b1].values[slot];
+        auto b2 = second_bucket(hash);
+        slot = find_in_bucket(b2, key, tag);
+        if (slot != SlotsPerBucket)
+            return &buckets[b2].values[slot];
+        for (const Entry &entry : stash)
+            if (key_equal_(entry.k, key))
+                return &entry.v;
+        return nullptr;
+    }
+
+    auto lookup(const Key &key) -> Value *
+    {
+        return const_cast<Value *>(static_cast<const CuckooHashMap *>(this)->lookup(key));
+    }
+
+    auto put(size_t bucket, size_t slot, uint8_t tag, Key key, Value value) -> void
+    {
+        Bucket &b = buckets[bucket];
+        b.set_tag(slot, tag);
+        b.keys[slot] = std::move(key);
+        b.values[slot] = std::move(value);
+    }
+
+    // Returns true if bucket is on the path from the root to the node
+    auto on_path(const std::vector<Path> &queue, int node, size_t bucket) const -> bool
+    {
+        for (; node != -1; node = queue[static_cast<size_t>(node)].parent)
+            if (queue[static_cast<size_t>(node)].bucket == bucket)
+                return true;
+        return false;
+    }
+
+    // Frees a slot in bucket b1 or b2 by moving keys to their other bucket. Returns the bucket and
+    // the slot which was freed, or a bucket equal to buckets.size() if no chain was found
+    auto make_room(size_t b1, size_t b2) -> std::pair<size_t, size_t>
+    {
+        std::vector<Path> queue;
+        queue.push_back({b1, -1, 0});
+        if (b2 != b1)
+            queue.push_back({b2, -1, 0});
+
+        for (size_t q = 0; q < queue.size() && queue.size() < MAX_SEARCH_NODES; ++q)
+        {
+            for (size_t slot = 0; slot < SlotsPerBucket; ++slot)
+            {
+                size_t bucket = queue[q].bucket;
+                auto alt = alternate(hash_of(buckets[bucket].keys[slot]), bucket);
+                if (alt == bucket || on_path(queue, static_cast<int>(q), alt))
+                    continue;
+                auto free = buckets[alt].free_slot();
+                if (free == SlotsPerBucket)
+                {
+                    queue.push_back({alt, static_cast<int>(q), slot});
+                    continue;
+                }
+
+                // Move the keys along the path, starting from the end
+                int node = static_cast<int>(q);
+                size_t to_bucket = alt, to_slot = free;
+                while (node != -1)
+                {
+                    const Path &p = queue[static_cast<size_t>(node)];
+                    Bucket &from = buckets[p.bucket];
+                    put(to_bucket, to_slot, from.tag_at(slot), std::move(from.keys[slot]),
+                        std::move(from.values[slot]));
+                    from.clear(slot);
+                    to_bucket = p.bucket;
+                    to_slot = slot;
+                    slot = p.slot;
+                    node = p.parent;
+                }
+                return {to_bucket, to_slot};
+            }
+        }
+        return {buckets.size(), 0};
+    }
+
+    // Places a key which is not in the table. Returns false if there is no room for it
+    auto place(Key key, Value value) -> bool
+    {
+        auto hash = hash_of(key);
+        auto tag = tag_of(hash);
+        auto b1 = first_bucket(hash), b2 = second_bucket(hash);
+        auto slot = buckets[b1].free_slot();
+        if (slot != SlotsPerBucket)
+        {
+            put(b1, slot, tag, std::move(key), std::move(value));
+            return true;
+        }
+        slot = buckets[b2].free_slot();
+        if (slot != SlotsPerBucket)
+        {
+            put(b2, slot, tag, std::move(key), std::move(value));
+            return true;
+        }
+        auto room = make_room(b1, b2);
+        if (room.first != buckets.size())
+        {
+            put(room.first, room.second, tag, std::move(key), std::move(value));
+            return true;
+        }
+        if (stash.size() < MAX_STASH_SIZE)
+        {
+            stash.push_back({std::move(key), std::move(value)});
+            return true;
+        }
+        return false;
+    }
+
+    // Rebuilds the table with at least new_buckets buckets, and at most max_buckets. Throws
+    // std::length_error, leaving the table as it was, if the keys do not fit in max_buckets
+    auto rehash(size_t new_buckets, size_t max_buckets) -> void
+    {
+        while (true)
+        {
+            if (new_buckets > max_buckets)
+                throw_too_many_collisions();
+            std::vector<Bucket> old_buckets(new_buckets);
+            std::vector<Entry> old_stash;
+            std::swap(buckets, old_buckets);
+            std::swap(stash, old_stash);
+            mask = new_buckets - 1;
+
+            bool placed = true;
+            for (size_t i = 0; i < old_buckets.size() && placed; ++i)
+                for (size_t s = 0; s < SlotsPerBucket && placed; ++s)
+                    if (old_buckets[i].occupied(s))
+                        placed = place(old_buckets[i].keys[s], old_buckets[i].values[s]);
+            for (size_t i = 0; i < old_stash.size() && placed; ++i)
+                placed = place(old_stash[i].k, old_stash[i].v);
+            if (placed)
+                return;
+
+            // Unlucky, restore the old table and try again with a larger one
+            std::swap(buckets, old_buckets);
+            std::swap(stash, old_stash);
+            mask = buckets.size() - 1;
+            new_buckets *= 2;
+        }
+    }
+
+    [[noreturn]] static auto throw_too_many_collisions() -> void
+    {
+        throw std::length_error("CuckooHashMap can not place the key, too many keys share the "
+                                "same buckets");
+    }
+
+    // Moves keys from the stash back to the buckets, if there is room for them
+    auto drain_stash() -> void
+    {
+        for (size_t i = 0; i < stash.size();)
+        {
+            auto hash = hash_of(stash[i].k);
+            auto b1 = first_bucket(hash), b2 = second_bucket(hash);
+            auto bucket = b1;
+            auto slot = buckets[b1].free_slot();
+            if (slot == SlotsPerBucket)
+            {
+                bucket = b2;
+                slot = buckets[b2].free_slot();
+            }
+            if (slot == SlotsPerBucket)
+            {
+                ++i;
+                continue;
+            }
+            put(bucket, slot, tag_of(hash), std::move(stash[i].k), std::move(stash[i].v));
+            stash[i] = std::move(stash.back());
+            stash.pop_back();
+        }
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.95f;
+    static constexpr size_t DEFAULT_START_BUCKETS_SIZE = 4;
+    static constexpr size_t MAX_STASH_SIZE = 8;
+    static constexpr size_t MAX_SEARCH_NODES = 512;
+    // An insert which still can not place its key after this many doublings of the table throws
+    // std::length_error
+    static constexpr size_t MAX_GROWS_PER_INSERT = 8;
+    static constexpr size_t SLOTS_PER_BUCKET = SlotsPerBucket;
+    // The number of cache lines of a bucket, a lookup reads one or two buckets
+    static constexpr size_t BUCKET_CACHE_LINES = sizeof(Bucket) / 64;
+
+    CuckooHashMap() : sz(0), mask(0), max_load_factor_(DEFAULT_MAX_LOAD_FACTOR) {}
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        auto value = lookup(key);
+        if (!value)
+            return std::nullopt;
+        return *value;
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        // Overwrite the value if there is an existing key
+        if (auto existing = lookup(key))
+        {
+            *existing = value;
+            return;
+        }
+        if (is_empty_key(key))
+        {
+            empty_key_value = value;
+            ++sz;
+            return;
+        }
+        // Doubling the table does not help keys which always hash to the same buckets, so the
+        // table grows at most MAX_GROWS_PER_INSERT times before the insert gives up
+        size_t max_buckets = std::max(buckets.size(), DEFAULT_START_BUCKETS_SIZE)
+                             << MAX_GROWS_PER_INSERT;
+        if (buckets.empty())
+            rehash(DEFAULT_START_BUCKETS_SIZE, max_buckets);
+        else if (static_cast<float>(sz + 1) > max_load_factor_ * static_cast<float>(capacity()))
+            rehash(buckets.size() * 2, max_buckets);
+        while (!place(key, value))
+            rehash(buckets.size() * 2, max_buckets);
+        ++sz;
+    }
+
+    auto erase(const Key &key) -> void
+    {
+        if (sz == 0)
+            return;
+        if (is_empty_key(key))
+        {
+            if (empty_key_value)
+            {
+                empty_key_value.reset();
+                --sz;
+            }
+            return;
+        }
+        auto hash = hash_of(key);
+        auto tag = tag_of(hash);
+        for (auto bucket : {first_bucket(hash), second_bucket(hash)})
+        {
+            auto slot = find_in_bucket(bucket, key, tag);
+            if (slot != SlotsPerBucket)
+            {
+                buckets[bucket].clear(slot);
+                --sz;
+                if (!stash.empty())
+                    drain_stash();
+                return;
+            }
+        }
+        for (size_t i = 0; i < stash.size(); ++i)
+        {
+            if (key_equal_(stash[i].k, key))
+            {
+                stash[i] = std::move(stash.back());
+                stash.pop_back();
+                --sz;
+                return;
+            }
+        }
+    }
+
+    auto contains(const Key &key) const -> bool { return lookup(key) != nullptr; }
+
+    auto size() const -> size_type { return sz; }
+
+    auto empty() const -> bool { return sz == 0; }
+
+    // Returns the number of slots in the table, not counting the stash
+    auto capacity() const -> size_type { return buckets.size() * SlotsPerBucket; }
+
+    auto stash_size() const -> size_type { return stash.size(); }
+
+    auto clear() -> void
+    {
+        std::fill(buckets.begin(), buckets.end(), Bucket());
+        stash.clear();
+        empty_key_value.reset();
+        sz = 0;
+    }
+
+    auto load_factor() const -> float
+    {
+        if (buckets.size())
+            return static_cast<float>(sz) / static_cast<float>(capacity());
+        return 0;
+    }
+
+    auto max_load_factor() const -> float { return max_load_factor_; }
+
+    auto max_load_factor(float new_max_load_factor) -> void
+    {
+        if (new_max_load_factor > 1.0f || new_max_load_factor <= 0.0f)
+            throw std::logic_error("Invalid Max load factor, it should be between 0 and 1");
+        max_load_factor_ = new_max_load_factor;
+    }
+};
+
+#endif // A_CUCKOO_HASHMAP_H
@@ -0,0 +1,238 @@
+#ifndef A_DENSE_HASHMAP_H
+#define A_DENSE_HASHMAP_H
+#include "hash.hpp"
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/*
+ * DenseHashMap
+ * ============
+ * A hash table which stores the key-value pairs contiguously, in the order of insertion
+ * Design choices
+ * 1) The entries are kept in a std::vector<std::pair<Key, Value>> with no gaps, so the memory used
+ * for the values is proportional to the number of keys and not to the size of the table. This
+ * matters when the values are large
+ * 2) The hash table itself is a compact index of 8 byte buckets, each holding the 32 bit offset of
+ * an entry and 32 bits of its hash. Probing compares the hash fragment first, so the entries are
+ * read only on a likely match
+ * 3) The index uses Robin Hood linear probing with backward shift deletion, over a power of two
+ * number of buckets. The home bucket is derived from the stored hash fragment, so growing the
+ * table rebuilds only the index, without hashing any key or moving any entry
+ * 4) Iterating over the map visits the entries in insertion order. erase() moves the last entry
+ * into the position of the erased one, so that it is O(1), which changes the order of that entry
+ * 5) At most 2^32 - 1 entries can be stored
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class DenseHashMap
+{
+  public:
+    using value_type = std::pair<Key, Value>;
+
+  private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Bucket
+    {
+        uint32_t offset = EMPTY;
+        uint32_t fragment = 0;
+    };
+
+    KeyEqual key_equal_;
+    Hash hasher_;
+    float max_load_factor_;
+    size_t mask;
+
+    std::vector<value_type> entries;
+    std::vector<Bucket> index;
+
+    auto fragment_of(const Key &key) const -> uint32_t
+    {
+        return static_cast<uint32_t>(mix64(static_cast<uint64_t>(hasher_(key))));
+    }
+
+    auto home(uint32_t fragment) const -> size_t { return fragment & mask; }
+
+    // Distance of the bucket at position i from the home bucket of its entry
+    auto distance(size_t i) const -> size_t { return (i - home(index[i].fragment)) & mask; }
+
+    // Returns the position of the bucket which points to the key, or index.size()
+    auto find_bucket(const Key &key) const -> size_t
+    {
+        if (entries.empty())
+            return index.size();
+        auto fragment = fragment_of(key);
+        auto i = home(fragment);
+        for (size_t dist = 0;; ++dist, i = (i + 1) & mask)
+        {
+            const Bucket &bucket = index[i];
+            if (bucket.offset == EMPTY || distance(i) < dist)
+                return index.size();
+            if (bucket.fragment == fragment && key_equal_(entries[bucket.offset].first, key))
+                return i;
+        }
+    }
+
+    // Adds a bucket to the index, there must be at least one empty bucket
+    auto place(Bucket bucket) -> void
+    {
+        auto i = home(bucket.fragment);
+        for (size_t dist = 0;; ++dist, i = (i + 1) & mask)
+        {
+            if (index[i].offset == EMPTY)
+            {
+                index[i] = bucket;
+                return;
+            }
+            auto existing = distance(i);
+            if (existing < dist)
+            {
+                std::swap(index[i], bucket);
+                dist = existing;
+            }
+        }
+    }
+
+    // Rebuilds the index with new_size buckets, only the buckets are moved
+    auto rebuild(size_t new_size) -> void
+    {
+        std::vector<Bucket> old_index(new_size);
+        std::swap(index, old_index);
+        mask = new_size - 1;
+        for (const Bucket &bucket : old_index)
+            if (bucket.offset != EMPTY)
+                place(bucket);
+    }
+
+    // Returns the position of the bucket which points to the entry at offset
+    auto bucket_of(uint32_t offset) const -> size_t
+    {
+        auto i = home(fragment_of(entries[offset].first));
+        while (index[i].offset != offset)
+            i = (i + 1) & mask;
+        return i;
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.8f;
+    static constexpr size_t DEFAULT_START_BUCKETS_SIZE = 8;
+
+    DenseHashMap() : max_load_factor_(DEFAULT_MAX_LOAD_FACTOR), mask(0) {}
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        auto i = find_bucket(key);
+        if (i == index.size())
+            return std::nullopt;
+        return entries[index[i].offset].second;
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        // Overwrite the value if there is an existing key
+        auto i = find_bucket(key);
+        if (i != index.size())
+        {
+            entries[index[i].offset].second = value;
+            return;
+        }
+        if (entries.size() >= EMPTY)
+            throw std::length_error("DenseHashMap can not hold more than 2^32 - 1 entries");
+
+        if (index.empty())
+            rebuild(DEFAULT_START_BUCKETS_SIZE);
+        else if (static_cast<float>(entries.size() + 1) >
+                 max_load_factor_ * static_cast<float>(index.size()))
+            rebuild(index.size() * 2);
+
+        Bucket bucket;
+        bucket.offset = static_cast<uint32_t>(entries.size());
+        bucket.fragment = fragment_of(key);
+        entries.emplace_back(key, value);
+        place(bucket);
+    }
+
+    auto erase(const Key &key) -> void
+    {
+        auto i = find_bucket(key);
+        if (i == index.size())
+            return;
+        auto offset = index[i].offset;
+
+        // Backward shift deletion in the index
+        auto next = (i + 1) & mask;
+        while (index[next].offset != EMPTY && distance(next) > 0)
+        {
+            index[i] = index[next];
+            i = next;
+            next = (i + 1) & mask;
+        }
+        index[i] = Bucket();
+
+        // Move the last entry into the hole, and point its bucket to the new position
+        auto last = static_cast<uint32_t>(entries.size() - 1);
+        if (offset != last)
+        {
+            index[bucket_of(last)].offset = offset;
+            entries[offset] = std::move(entries[last]);
+        }
+        entries.pop_back();
+    }
+
+    auto contains(const Key &key) const -> bool { return find_bucket(key) != index.size(); }
+
+    auto size() const -> size_type { return entries.size(); }
+
+    auto empty() const -> bool { return entries.empty(); }
+
+    auto clear() -> void
+    {
+        entries.clear();
+        std::fill(index.begin(), index.end(), Bucket());
+    }
+
+    // Reserves space for n entries, so that inserting them does not rebuild the index
+    auto reserve(size_t n) -> void
+    {
+        entries.reserve(n);
+        size_t new_size = index.empty() ? DEFAULT_START_BUCKETS_SIZE : index.size();
+        while (max_load_factor_ * static_cast<float>(new_size) < static_cast<float>(n))
+            new_size *= 2;
+        if (new_size != index.size())
+            rebuild(new_size);
+    }
+
+    // Iteration visits the entries in insertion order
+    auto begin() const -> const_iterator { return entries.begin(); }
+
+    auto end() const -> const_iterator { return entries.end(); }
+
+    auto load_factor() const -> float
+    {
+        if (index.size())
+            return static_cast<float>(entries.size()) / static_cast<float>(index.size());
+        return 0;
+    }
+
+    auto max_load_factor() const -> float { return max_load_factor_; }
+
+    auto max_load_factor(float new_max_load_factor) -> void
+    {
+        if (new_max_load_factor > 1.0f || new_max_load_factor <= 0.0f)
+            throw std::logic_error("Invalid Max load factor, it should be between 0 and 1");
+        max_load_factor_ = new_max_load_factor;
+    }
+};
+
+#endif // A_DENSE_HASHMAP_H
@@ -0,0 +1,277 @@
+#pragma once
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+// A priority queue which keeps most of its elements in files, for queues larger than the memory
+//
+// New elements go into an in-memory PriorityQueue, the insertion heap. When it is full, its
+// elements are popped in order and written to a new file, a sorted run. Each run keeps its largest
+// remaining elements in a buffer of one block, and the first element of every buffer (the head of
+// the run) is in a second heap. The top of the queue is the larger of the tops of the two heaps,
+// so pop is a k-way merge of the runs, mixed with the insertion heap
+//
+// All reads and writes are sequential and one block long. The memory budget is split in two
+// halves, one for the insertion heap and one for the buffers of the runs, one block each. When
+// there are more runs than buffers fit in the budget, the half of the runs with the fewest
+// elements left are merged into one. As with the levels of a merge sort, runs of similar size are
+// merged together, so every element is written O(log(spills) / log(runs merged)) times in total
+//
+// As with PriorityQueue, the top is the largest element under Compare. Elements are written to
+// the files as they are in memory, so T must be trivially copyable. The runs are temporary files
+// in the given directory, which are removed when they are fully read or when the queue is destroyed
+template <typename T, typename Compare = std::less<T>> class ExternalPriorityQueue
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable elements can be written to a run");
+
+  private:
+    // A sorted run, read one block at a time
+    struct Run
+    {
+        std::string path;
+        std::ifstream in;
+        std::vector<T> buffer;
+        size_t position;
+        // The number of elements in the file which are not in the buffer yet
+        size_t unread;
+
+        Run(std::string p, size_t count) : path(std::move(p)), position(0), unread(count) {}
+
+        Run(const Run &) = delete;
+
+        Run &operator=(const Run &) = delete;
+
+        ~Run()
+        {
+            in.close();
+            std::remove(path.c_str());
+        }
+
+        // Reads the next block into the buffer, returns false at the end of the run
+        bool refill(size_t block_elements)
+        {
+            buffer.resize(std::min(block_elements, unread));
+            position = 0;
+            if (buffer.empty())
+                return false;
+            if (!in.read(reinterpret_cast<char *>(buffer.data()),
+                         static_cast<std::streamsize>(buffer.size() * sizeof(T))))
+                throw std::runtime_error("Could not read the run " + path);
+            unread -= buffer.size();
+            return true;
+        }
+    };
+
+    // The first element of a run, in the heap of run heads
+    struct Head
+    {
+        T value;
+        size_t run;
+    };
+
+    struct HeadCompare
+    {
+        Compare comp;
+
+        bool operator()(const Head &a, const Head &b) const { return comp(a.value, b.value); }
+    };
+
+    typedef PriorityQueue<Head, std::vector<Head>, HeadCompare> HeadQueue;
+
+    std::string directory;
+    size_t heap_capacity;
+    size_t block_elements;
+    size_t max_runs;
+    Compare comp;
+    PriorityQueue<T, std::vector<T, CacheAlignedAllocator<T>>, Compare> heap;
+    HeadQueue heads;
+    // A run which was fully read leaves a null entry, which is reused by the next run
+    std::vector<std::unique_ptr<Run>> runs;
+    size_t live_runs;
+    size_t sz;
+    size_t written_bytes;
+
+    // Creates an empty file with a unique name in the directory, and returns its path
+    std::string make_run_path()
+    {
+        std::string pattern = directory + "/external_priority_queue_XXXXXX";
+        std::vector<char> name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+        int fd = mkstemp(name.data());
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(),
+                                    "Could not create a run in " + directory);
+        close(fd);
+        return std::string(name.data());
+    }
+
+    // Writes count elements, produced in order by next(), to a new run
+    template <typename Next> void write_run(size_t count, Next next)
+    {
+        auto run = std::make_unique<Run>(make_run_path(), count);
+        {
+            std::ofstream out(run->path, std::ios::binary | std::ios::trunc);
+            std::vector<T> block;
+            block.reserve(block_elements);
+            for (size_t written = 0; written < count;)
+            {
+                block.clear();
+                for (; block.size() < block_elements && written < count; ++written)
+                    block.push_back(next());
+                out.write(reinterpret_cast<const char *>(block.data()),
+                          static_cast<std::streamsize>(block.size() * sizeof(T)));
+                written_bytes += block.size() * sizeof(T);
+            }
+            if (!out.flush())
+                throw std::runtime_error("Could not write the run " + run->path);
+        }
+        run->in.open(run->path, std::ios::binary);
+        if (!run->in || !run->refill(block_elements))
+            throw std::runtime_error("Could not open the run " + run->path);
+        size_t index = static_cast<size_t>(
+            std::find(runs.begin(), runs.end(), nullptr) - runs.begin());
+        if (index == runs.size())
+            runs.emplace_back();
+        heads.push(Head{run->buffer[0], index});
+        runs[index] = std::move(run);
+        ++live_runs;
+    }
+
+    // Replaces the head of a run, which is the top of from, with its next element
+    void advance(HeadQueue &from, size_t index)
+    {
+        Run &run = *runs[index];
+        from.pop();
+        if (++run.position == run.buffer.size() && !run.refill(block_elements))
+        {
+            runs[index].reset();
+            --live_runs;
+            return;
+        }
+        from.push(Head{run.buffer[run.position], index});
+    }
+
+    // The number of elements of a run which were not popped yet
+    static size_t remaining(const Run &run)
+    {
+        return run.buffer.size() - run.position + run.unread;
+    }
+
+    // Writes the insertion heap to a new run
+    void spill()
+    {
+        write_run(heap.size(),
+                  [this]
+                  {
+                      T value = heap.top();
+                      heap.pop();
+                      return value;
+                  });
+        if (live_runs > max_runs)
+            merge_runs();
+    }
+
+    // Merges the max_runs / 2 runs with the fewest elements left into one. Their heads move to a
+    // heap of their own, which is popped in order, and the runs are removed as they are read to
+    // the end
+    void merge_runs()
+    {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < runs.size(); ++i)
+            if (runs[i])
+                order.push_back(i);
+        size_t fan_in = std::min(order.size(), std::max<size_t>(2, max_runs / 2));
+        std::nth_element(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(fan_in - 1),
+                         order.end(), [this](size_t a, size_t b)
+                         { return remaining(*runs[a]) < remaining(*runs[b]); });
+        std::vector<Head> merged, kept;
+        size_t count = 0;
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            const Run &run = *runs[order[k]];
+            (k < fan_in ? merged : kept).push_back(Head{run.buffer[run.position], order[k]});
+            if (k < fan_in)
+                count += remaining(run);
+        }
+        heads = HeadQueue(kept.begin(), kept.end(), HeadCompare{comp});
+        HeadQueue sources(merged.begin(), merged.end(), HeadCompare{comp});
+        write_run(count,
+                  [this, &sources]
+                  {
+                      T value = sources.top().value;
+                      advance(sources, sources.top().run);
+                      return value;
+                  });
+    }
+
+    bool top_in_heap() const
+    {
+        return heads.empty() || (!heap.empty() && !comp(heap.top(), heads.top().value));
+    }
+
+  public:
+    typedef T value_type;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef Compare value_compare;
+    static constexpr size_t DEFAULT_MEMORY_BYTES = size_t(64) << 20;
+    static constexpr size_t DEFAULT_BLOCK_BYTES = size_t(1) << 20;
+
+    // Keeps the runs in directory, and uses about memory_bytes of memory for the insertion heap
+    // and the buffers, which hold block_bytes each
+    explicit ExternalPriorityQueue(const std::string &dir,
+                                   size_t memory_bytes = DEFAULT_MEMORY_BYTES,
+                                   size_t block_bytes = DEFAULT_BLOCK_BYTES,
+                                   const Compare &compare = Compare())
+        : directory(dir), heap_capacity(memory_bytes / 2 / sizeof(T)),
+          block_elements(block_bytes / sizeof(T)), comp(compare), heap(compare),
+          heads(HeadCompare{compare}), live_runs(0), sz(0), written_bytes(0)
+    {
+        if (heap_capacity == 0 || block_elements == 0 || block_bytes > memory_bytes / 2)
+            throw std::logic_error("The memory budget should hold at least two blocks");
+        max_runs = std::max<size_t>(2, memory_bytes / 2 / block_bytes);
+    }
+
+    const_reference top() const { return top_in_heap() ? heap.top() : heads.top().value; }
+
+    size_type size() const { return sz; }
+
+    bool empty() const { return sz == 0; }
+
+    value_compare value_comp() const { return comp; }
+
+    void push(const value_type &value)
+    {
+        if (heap.size() == heap_capacity)
+            spill();
+        heap.push(value);
+        ++sz;
+    }
+
+    void pop()
+    {
+        if (top_in_heap())
+            heap.pop();
+        else
+            advance(heads, heads.top().run);
+        --sz;
+    }
+
+    // The number of runs on disk
+    size_type run_count() const { return live_runs; }
+
+    // The number of bytes written to runs since the queue was created
+    size_type bytes_written() const { return written_bytes; }
+};
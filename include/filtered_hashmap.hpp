@@ -0,0 +1,111 @@
+#ifndef A_FILTERED_HASHMAP_H
+#define A_FILTERED_HASHMAP_H
+#include "bloom_filter.hpp"
+#include "hashmap.hpp"
+#include <optional>
+
+/*
+ * FilteredHashMap
+ * ===============
+ * A HashMap with a BloomFilter of its keys in front of it, for workloads where most lookups are
+ * for keys which do not exist
+ * Design choices
+ * 1) find and contains test the filter first. For a key which was never inserted the filter
+ * usually answers no after reading one cache line, and the probe sequence of the table is not
+ * walked at all
+ * 2) The filter is sized for twice the number of keys, and rebuilt from the keys of the table when
+ * the table outgrows it, so inserts stay amortized O(1) and the false positive rate stays near the
+ * one of bits_per_key
+ * 3) Keys can not be removed from a Bloom filter, erase leaves their bits set. Once as many keys
+ * were erased as are left in the table, the filter is rebuilt
+ * 4) filter() gives access to the filter, which can be saved and shipped on its own
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>, typename CapacityPolicy = ModuloCapacity>
+class FilteredHashMap
+{
+  private:
+    using Map = HashMap<Key, Value, Hash, KeyEqual, CapacityPolicy>;
+    using Filter = BloomFilter<Key, Hash>;
+
+    Map map;
+    Filter filter_;
+    double bits_per_key_;
+    // Number of keys the filter was sized for, and number of keys erased since it was built
+    size_t filter_capacity, erased;
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    static constexpr size_t DEFAULT_FILTER_CAPACITY = 1024;
+
+    explicit FilteredHashMap(double bits_per_key = Filter::DEFAULT_BITS_PER_KEY)
+        : filter_(DEFAULT_FILTER_CAPACITY, bits_per_key), bits_per_key_(bits_per_key),
+          filter_capacity(DEFAULT_FILTER_CAPACITY), erased(0)
+    {
+    }
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        if (!filter_.may_contain(key))
+            return std::nullopt;
+        return map.find(key);
+    }
+
+    auto contains(const Key &key) const -> bool
+    {
+        return filter_.may_contain(key) && map.contains(key);
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        auto old_size = map.size();
+        map.insert(key, value);
+        if (map.size() == old_size)
+            return;
+        if (map.size() > filter_capacity)
+            rebuild_filter();
+        else
+            filter_.insert(key);
+    }
+
+    auto erase(const Key &key) -> void
+    {
+        auto old_size = map.size();
+        map.erase(key);
+        if (map.size() != old_size && ++erased > map.size())
+            rebuild_filter();
+    }
+
+    // Builds a new filter from the keys of the table, with room for twice as many keys
+    auto rebuild_filter() -> void
+    {
+        filter_capacity = std::max(DEFAULT_FILTER_CAPACITY, map.size() * 2);
+        filter_ = Filter(filter_capacity, bits_per_key_);
+        erased = 0;
+        for (const auto *table : {&map.slots, &map.old_slots})
+            for (const auto &slot : *table)
+                if (!slot.empty())
+                    filter_.insert(slot.k);
+    }
+
+    auto size() const -> size_type { return map.size(); }
+
+    auto empty() const -> bool { return map.size() == 0; }
+
+    auto clear() -> void
+    {
+        map.clear();
+        filter_.clear();
+        erased = 0;
+    }
+
+    auto filter() const -> const Filter & { return filter_; }
+
+    auto bits_per_key() const -> double { return bits_per_key_; }
+};
+
+#endif // A_FILTERED_HASHMAP_H
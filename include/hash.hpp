@@ -0,0 +1,157 @@
+#ifndef A_HASH_H
+#define A_HASH_H
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Hash functions
+ * ==============
+ * WyHash::hash(data, length, seed) - A fast 64 bit hash of a byte string (wyhash, final version
+ * 4). It reads 16 or 48 bytes per step with 64x64 -> 128 bit multiplications, and short strings
+ * are read with a few overlapping loads and no loop. Not a cryptographic hash
+ *
+ * StringHash - Hashes std::string, std::string_view and C strings with wyhash. It declares
+ * is_transparent, so a HashMap<std::string, Value, StringHash, std::equal_to<>> can be searched
+ * with a std::string_view or a const char * without constructing a std::string
+ *
+ * mix64(h) - The splitmix64 finalizer. The tables and filters apply it to the result of their
+ * Hash, so that weak hashes such as the identity std::hash<int> still spread over all the bits
+ */
+
+// True if T declares is_transparent. K is only there to make the check depend on the template
+// parameter of a lookup function, so that it can be used for SFINAE
+template <typename T, typename K = void, typename = void>
+struct has_is_transparent : std::false_type
+{
+};
+
+template <typename T, typename K>
+struct has_is_transparent<T, K, std::void_t<typename T::is_transparent>> : std::true_type
+{
+};
+
+inline auto mix64(uint64_t h) -> uint64_t
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+class WyHash
+{
+  private:
+    __extension__ using uint128 = unsigned __int128;
+
+    static constexpr uint64_t SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                           0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+    static auto mum(uint64_t &a, uint64_t &b) -> void
+    {
+        uint128 r = static_cast<uint128>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+    }
+
+    static auto mix(uint64_t a, uint64_t b) -> uint64_t
+    {
+        mum(a, b);
+        return a ^ b;
+    }
+
+    // Unaligned little endian loads
+    static auto read8(const unsigned char *p) -> uint64_t
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    static auto read4(const unsigned char *p) -> uint64_t
+    {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    // Reads 1 to 3 bytes
+    static auto read3(const unsigned char *p, size_t k) -> uint64_t
+    {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) |
+               p[k - 1];
+    }
+
+  public:
+    static auto hash(const void *data, size_t length, uint64_t seed = 0) -> uint64_t
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+        uint64_t a, b;
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                a = (read4(p) << 32) | read4(p + ((length >> 3) << 2));
+                b = (read4(p + length - 4) << 32) | read4(p + length - 4 - ((length >> 3) << 2));
+            }
+            else if (length > 0)
+            {
+                a = read3(p, length);
+                b = 0;
+            }
+            else
+                a = b = 0;
+        }
+        else
+        {
+            size_t i = length;
+            if (i > 48)
+            {
+                uint64_t see1 = seed, see2 = seed;
+                do
+                {
+                    seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                    see1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ see1);
+                    see2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (i > 16)
+            {
+                seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            // The last 16 bytes, which may overlap the bytes which were already hashed
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+        }
+        a ^= SECRET[1];
+        b ^= seed;
+        mum(a, b);
+        return mix(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+    }
+};
+
+struct StringHash
+{
+    using is_transparent = void;
+
+    auto operator()(std::string_view s) const -> size_t
+    {
+        return static_cast<size_t>(WyHash::hash(s.data(), s.size()));
+    }
+
+    auto operator()(const std::string &s) const -> size_t { return (*this)(std::string_view(s)); }
+
+    auto operator()(const char *s) const -> size_t { return (*this)(std::string_view(s)); }
+};
+
+#endif // A_HASH_H
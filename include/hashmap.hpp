@@ -1,11 +1,150 @@
 #ifndef A_HASHMAP_H
 #define A_HASHMAP_H
+#include "hash.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <optional>
+#include <stdexcept>
 #include <stdint.h>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+/*
+ * Statistics
+ * ==========
+ * The Stats parameter of HashMap decides whether the table collects statistics about itself
+ *     * NoHashMapStats - The default, nothing is collected and every hook compiles to nothing
+ *     * HashMapStats - Collects probe length histograms of find() and contains() (hits and misses
+ *       separately), the maximum displacement of an inserted entry and the time taken by each call
+ *       to grow()
+ * The statistics are printed with HashMap::dump_stats(). Lookups update the statistics even though
+ * they are const, so a table with HashMapStats must not be read from several threads at once
+ */
+struct NoHashMapStats
+{
+    static constexpr bool enabled = false;
+
+    auto record_find(size_t, bool) -> void {}
+
+    auto record_displacement(size_t) -> void {}
+
+    auto record_grow(double) -> void {}
+
+    auto reset() -> void {}
+};
+
+struct HashMapStats
+{
+    static constexpr bool enabled = true;
+    // Probe lengths of HISTOGRAM_SIZE or more are counted in the last bucket
+    static constexpr size_t HISTOGRAM_SIZE = 32;
+
+    std::array<uint64_t, HISTOGRAM_SIZE> hit_probe_lengths{}, miss_probe_lengths{};
+    size_t max_displacement = 0;
+    // Time taken by each call to grow(), in seconds
+    std::vector<double> grow_seconds;
+
+    auto record_find(size_t probe_length, bool hit) -> void
+    {
+        auto &histogram = hit ? hit_probe_lengths : miss_probe_lengths;
+        ++histogram[std::min(probe_length, HISTOGRAM_SIZE - 1)];
+    }
+
+    auto record_displacement(size_t displacement) -> void
+    {
+        max_displacement = std::max(max_displacement, displacement);
+    }
+
+    auto record_grow(double seconds) -> void { grow_seconds.push_back(seconds); }
+
+    auto reset() -> void { *this = HashMapStats(); }
+};
+
+// Holds the Stats of a HashMap. An empty Stats, such as NoHashMapStats, is a base class instead of
+// a member, so that it takes no storage (the empty base optimization)
+template <typename Stats, bool = std::is_empty<Stats>::value && !std::is_final<Stats>::value>
+class HashMapStatsStorage
+{
+    mutable Stats stats_;
+
+  protected:
+    auto stats_ref() const -> Stats & { return stats_; }
+};
+
+template <typename Stats> class HashMapStatsStorage<Stats, true> : private Stats
+{
+  protected:
+    // Stats has no members, so nothing is ever written through the reference
+    auto stats_ref() const -> Stats & { return const_cast<HashMapStatsStorage &>(*this); }
+};
+
+// Header of the file written by HashMap::save, the slots follow at offset SLOTS_OFFSET
+struct HashMapSnapshotHeader
+{
+    static constexpr uint64_t MAGIC = 0x50414d4853415344ULL; // "DSAHSMAP"
+    static constexpr uint32_t VERSION = 3;
+    static constexpr uint64_t SLOTS_OFFSET = 64;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint64_t size;
+    uint64_t capacity;
+    uint64_t slots_offset;
+    // The TAG of the capacity policy, and the hashes of a few keys, so that a table is not opened
+    // with a policy or a hash function which would look for the keys in other slots
+    uint32_t capacity_policy;
+    uint32_t reserved;
+    uint64_t hash_fingerprint;
+};
+
+// The TAG of a capacity policy, or 0 for a policy which does not declare one
+template <typename CapacityPolicy, typename = void> struct capacity_policy_tag
+{
+    static constexpr uint32_t value = 0;
+};
+
+template <typename CapacityPolicy>
+struct capacity_policy_tag<CapacityPolicy, std::void_t<decltype(CapacityPolicy::TAG)>>
+{
+    static constexpr uint32_t value = CapacityPolicy::TAG;
+};
+
+// Combines the hashes of a few keys. Two hash functions which place keys differently almost surely
+// give different fingerprints. Integer keys are probed with several values, other keys with the
+// value initialized key only
+template <typename Key, typename Hash> auto hash_fingerprint(const Hash &hasher) -> uint64_t
+{
+    uint64_t fingerprint = 0;
+    auto add = [&fingerprint](uint64_t hash)
+    {
+        fingerprint ^= hash + 0x9E3779B97F4A7C15ULL + (fingerprint << 6) + (fingerprint >> 2);
+    };
+    if constexpr (std::is_integral<Key>::value)
+    {
+        for (uint64_t probe : {0ULL, 1ULL, 42ULL, 0x5bd1e995ULL, 0x7fffffffULL})
+            add(static_cast<uint64_t>(hasher(static_cast<Key>(probe))));
+    }
+    else if constexpr (std::is_default_constructible<Key>::value)
+        add(static_cast<uint64_t>(hasher(Key{})));
+    return fingerprint;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename CapacityPolicy>
+class MappedHashMap;
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename CapacityPolicy>
+class FilteredHashMap;
+
 /*
  * HashMap
  * =========
@@ -14,61 +153,566 @@
  * 1) No iterators - For simplicity and faster access, this implementation does not implement
  * iterators 2) Supports three main operations, along with three other operations
  *     * find(Key) - Returns an optional value
+ *     * find_ptr(Key) - Returns a pointer to the value, or nullptr
  *     * insert(Key, Value) - Inserts the Key-Value pair into the hash table
  *     * erase(Key) - Deletes the key if it exists
+ *     * upsert(Key, Fn) - Updates the value of the key in place, inserting it if required
  *     * contains(Key) - Returns true if the key exists
  *     * size() - Returns the number of keys in the hash table
  *     * clear() - Remove all keys from the table
+ *     * find_batch(Keys, n, Out), insert_batch(Keys, Values, n) - Batched versions of find and
+ *       insert, which prefetch the slots of many keys at once
+ *     * bulk_build(First, Last[, Pool]), rehash(n[, Pool]) - Insert a range of pairs, or resize
+ *       the table, with a single rebuild of the table, optionally in parallel on a ThreadPool
  * 3) To improve cache efficiency, the table uses open addressing collision resolution mechanism
  * 4) The current implementation requires Key and Value to be DefaultConstructible
+ * 5) Collisions are resolved with Robin Hood linear probing. Every slot remembers how far it is
+ * from its home slot (the probe distance), and an insertion takes the slot of any entry which is
+ * closer to its home than the new entry is. This keeps the probe distances even, and a lookup can
+ * stop as soon as it sees an entry which is closer to its home than the key would be
+ * 6) erase() uses backward shift deletion, the entries after the erased slot are moved back by one
+ * slot until an empty slot or an entry in its home slot is found. No tombstones are left behind, so
+ * lookups do not slow down after many insertions and deletions
+ * 7) By default, the insert which crosses the max load factor moves every entry to a larger table.
+ * With rehash_step(n), the old table is instead kept next to the new one, and every insert, find
+ * and erase moves the entries from the next n slots of the old table. Lookups check both tables
+ * until the move is complete. This bounds the latency of a single operation on large tables. The
+ * step is raised when needed so that the move always ends before the table grows again
+ * 8) The CapacityPolicy decides how a hash is mapped to a slot. ModuloCapacity (the default) uses
+ * the remainder, PowerOfTwoCapacity and FastRangeCapacity avoid the division on every probe
+ * 9) If Key and Value are trivially copyable, save(path) writes the slots to a file as they are in
+ * memory. The file can be served read only without deserializing it, with MappedHashMap (see
+ * mapped_hashmap.hpp)
+ * 10) With Stats = HashMapStats, the table records probe lengths, displacements and resizes, see
+ * dump_stats(). The default NoHashMapStats has no cost
+ * 11) If Hash and KeyEqual declare is_transparent, find, find_ptr and contains accept keys of other
+ * types. HashMap<std::string, Value, StringHash, std::equal_to<>> (see hash.hpp) hashes strings
+ * with wyhash and can be searched with a std::string_view or a C string without allocating
+ */
+/*
+ * Capacity policies
+ * =================
+ * A capacity policy decides the sizes the table can have, and maps a hash to a slot index
+ *     * round_up(n) - Returns the smallest valid table size which is at least n
+ *     * reset(n) - Called when a table of size n is allocated
+ *     * index(hash) - Returns the home slot of hash, in the range [0, n)
+ *     * TAG - Optional, a number which identifies the policy in the files written by save
  */
+
+// Any table size is allowed, the index is the remainder of the hash. This is the default policy
+struct ModuloCapacity
+{
+    static constexpr uint32_t TAG = 1;
+
+    size_t size = 0;
+
+    static auto round_up(size_t n) -> size_t { return n; }
+
+    auto reset(size_t n) -> void { size = n; }
+
+    auto index(size_t hash) const -> size_t { return hash % size; }
+};
+
+// The table size is a power of two. The hash is multiplied by 2^64 / golden ratio (Fibonacci
+// hashing) and the top bits of the product are used as the index, so that weak hashes such as the
+// identity std::hash<int> still spread over the whole table. There is no division
+struct PowerOfTwoCapacity
+{
+    static constexpr uint32_t TAG = 2;
+
+    unsigned shift = 64;
+
+    static auto round_up(size_t n) -> size_t
+    {
+        size_t size = 1;
+        while (size < n)
+            size *= 2;
+        return size;
+    }
+
+    auto reset(size_t n) -> void
+    {
+        shift = 64;
+        for (size_t size = 1; size < n; size *= 2)
+            --shift;
+    }
+
+    auto index(size_t hash) const -> size_t
+    {
+        if (shift == 64)
+            return 0;
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+};
+
+// Any table size is allowed, the index is computed as (mixed hash * size) / 2^64 with a 128 bit
+// multiplication (Lemire's fast range reduction) instead of a division. The hash is mixed first,
+// as the reduction only uses its upper bits
+struct FastRangeCapacity
+{
+    static constexpr uint32_t TAG = 3;
+
+    uint64_t size = 0;
+
+    static auto round_up(size_t n) -> size_t { return n; }
+
+    auto reset(size_t n) -> void { size = n; }
+
+    auto index(size_t hash) const -> size_t
+    {
+        __extension__ using uint128 = unsigned __int128;
+        uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>((static_cast<uint128>(mixed) * size) >> 64);
+    }
+};
+
 template <typename Key, typename Value, typename Hash = std::hash<Key>,
-          typename KeyEqual = std::equal_to<Key>>
-class HashMap
+          typename KeyEqual = std::equal_to<Key>, typename CapacityPolicy = ModuloCapacity,
+          typename Stats = NoHashMapStats>
+class HashMap : private HashMapStatsStorage<Stats>
 {
   private:
+    friend class MappedHashMap<Key, Value, Hash, KeyEqual, CapacityPolicy>;
+    friend class FilteredHashMap<Key, Value, Hash, KeyEqual, CapacityPolicy>;
+
     KeyEqual key_equal_;
     Hash hasher_;
-    size_t sz, number_of_slots_used, number_of_slots_total;
+    size_t sz, number_of_slots_total;
     float max_load_factor_, growth_factor_;
 
     struct Slot
     {
+        // The dist of an empty slot. A probe sequence is shorter than the table, so it never
+        // reaches this value in tables of up to 2^32 - 1 slots
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
         Key k;
         Value v;
-        enum class State
-        {
-            FILLED,
-            TOMBSTONE,
-            EMPTY
-        };
-        State state = State::EMPTY;
+        // Distance of this slot from the home slot of the key, or EMPTY. It shares the padding
+        // after small keys and values, instead of a separate state field
+        uint32_t dist = EMPTY;
+
+        bool empty() const { return dist == EMPTY; }
     };
 
     std::vector<Slot> slots;
 
+    // While the table is being resized incrementally, entries which have not been moved yet are
+    // in old_slots. All slots of old_slots before migrate_position are empty
+    std::vector<Slot> old_slots;
+    size_t migrate_position, rehash_step_;
+    // The number of slots moved per operation during the current resize, at least rehash_step_
+    size_t migrate_step_size;
+    CapacityPolicy capacity_policy, old_capacity_policy;
+
+    template <typename K> auto home(const K &key, const CapacityPolicy &policy) const -> size_t
+    {
+        return policy.index(hasher_(key));
+    }
+
+    static auto next(size_t index, size_t total) -> size_t
+    {
+        return index + 1 == total ? 0 : index + 1;
+    }
+
+    // Returns the index of the slot of table which holds the key, or table.size() if it does not
+    // exist
+    template <typename K>
+    auto find_in(const std::vector<Slot> &table, const CapacityPolicy &policy, const K &key) const
+        -> size_t
+    {
+        size_t probes = 0;
+        return find_in(table, policy, key, probes);
+    }
+
+    // Same as find_in, and adds the number of slots which were examined to probes
+    template <typename K>
+    auto find_in(const std::vector<Slot> &table, const CapacityPolicy &policy, const K &key,
+                 size_t &probes) const -> size_t
+    {
+        if (sz == 0 || table.empty())
+            return table.size();
+        return find_from(table, key, home(key, policy), probes);
+    }
+
+    // Same as find_in, when the home slot of the key is already known
+    template <typename K>
+    auto find_from(const std::vector<Slot> &table, const K &key, size_t index,
+                   size_t &probes) const -> size_t
+    {
+        return probe(table.data(), table.size(), key, index, key_equal_, probes);
+    }
+
+    template <typename K>
+    auto find_from(const std::vector<Slot> &table, const K &key, size_t index) const -> size_t
+    {
+        size_t probes = 0;
+        return find_from(table, key, index, probes);
+    }
+
+    // Robin Hood lookup in a table of total slots, starting at the home slot index. Returns the
+    // index of the slot which holds the key, or total. The number of slots which were examined is
+    // added to probes
+    template <typename K>
+    static auto probe(const Slot *table, size_t total, const K &key, size_t index,
+                      const KeyEqual &equal, size_t &probes) -> size_t
+    {
+        for (size_t dist = 0;; ++dist)
+        {
+            const Slot &slot = table[index];
+            // If the key was present, it would have taken this slot during insertion
+            if (slot.empty() || slot.dist < dist)
+            {
+                probes += dist + 1;
+                return total;
+            }
+            if (slot.dist == dist && equal(slot.k, key))
+            {
+                probes += dist + 1;
+                return index;
+            }
+            index = next(index, total);
+        }
+    }
+
+    auto find_index(const Key &key) const -> size_t { return find_in(slots, capacity_policy, key); }
+
+    // Returns the slot which holds the key in either of the tables, or nullptr. The number of
+    // slots which were examined is added to probes
+    template <typename K> auto lookup(const K &key, size_t &probes) const -> const Slot *
+    {
+        auto index = find_in(slots, capacity_policy, key, probes);
+        if (index != number_of_slots_total)
+            return &slots[index];
+        index = find_in(old_slots, old_capacity_policy, key, probes);
+        if (index != old_slots.size())
+            return &old_slots[index];
+        return nullptr;
+    }
+
+    template <typename K> auto lookup(const K &key) const -> const Slot *
+    {
+        size_t probes = 0;
+        return lookup(key, probes);
+    }
+
+    // Same as lookup, and records the probe length in the statistics
+    template <typename K> auto recorded_lookup(const K &key) const -> const Slot *
+    {
+        size_t probes = 0;
+        auto slot = lookup(key, probes);
+        if constexpr (Stats::enabled)
+            this->stats_ref().record_find(probes, slot != nullptr);
+        return slot;
+    }
+
+    template <typename K> auto lookup(const K &key) -> Slot *
+    {
+        return const_cast<Slot *>(static_cast<const HashMap *>(this)->lookup(key));
+    }
+
+    template <typename K> auto find_value(const K &key) const -> std::optional<Value>
+    {
+        auto slot = recorded_lookup(key);
+        if (!slot)
+            return std::nullopt;
+        return slot->v;
+    }
+
+    template <typename K> auto find_value_ptr(const K &key) const -> const Value *
+    {
+        auto slot = recorded_lookup(key);
+        return slot ? &slot->v : nullptr;
+    }
+
+    template <typename K>
+    using if_transparent = std::enable_if_t<has_is_transparent<Hash, K>::value &&
+                                            has_is_transparent<KeyEqual, K>::value>;
+
+    // Removes the entry at index from table. The following entries are shifted back by one slot,
+    // until an entry which is already in its home slot (or an empty slot) is found
+    static auto erase_at(std::vector<Slot> &table, size_t index) -> void
+    {
+        auto next_index = next(index, table.size());
+        while (!table[next_index].empty() && table[next_index].dist > 0)
+        {
+            table[index] = std::move(table[next_index]);
+            --table[index].dist;
+            index = next_index;
+            next_index = next(index, table.size());
+        }
+        table[index] = Slot();
+    }
+
+    // Places an entry whose key is not in the table, there must be at least one empty slot.
+    // Returns the index of the slot where the entry was placed
+    auto place(Slot entry) -> size_t
+    {
+        auto index = home(entry.k, capacity_policy);
+        return place(std::move(entry), index);
+    }
+
+    // Same as place, when the home slot of the key is already known
+    auto place(Slot entry, size_t index) -> size_t
+    {
+        entry.dist = 0;
+        auto placed_at = number_of_slots_total;
+        while (true)
+        {
+            Slot &slot = slots[index];
+            if (slot.empty())
+            {
+                if constexpr (Stats::enabled)
+                    this->stats_ref().record_displacement(entry.dist);
+                slot = std::move(entry);
+                return placed_at == number_of_slots_total ? index : placed_at;
+            }
+            // Take the slot from an entry which is closer to its home, and continue placing it
+            if (slot.dist < entry.dist)
+            {
+                if constexpr (Stats::enabled)
+                    this->stats_ref().record_displacement(entry.dist);
+                std::swap(slot, entry);
+                if (placed_at == number_of_slots_total)
+                    placed_at = index;
+            }
+            index = next(index, number_of_slots_total);
+            ++entry.dist;
+        }
+    }
+
+    // Inserts a key which is not in the table, and returns the index of its slot
+    auto insert_new(const Key &key, const Value &value) -> size_t
+    {
+        if (number_of_slots_total == 0 || load_factor() >= max_load_factor())
+            grow();
+
+        Slot entry;
+        entry.k = key;
+        entry.v = value;
+        ++sz;
+        return place(std::move(entry));
+    }
+
+    // Moves entries from old_slots to slots, visiting at most max_slots slots of old_slots
+    auto migrate(size_t max_slots) -> void
+    {
+        for (; max_slots > 0 && migrate_position < old_slots.size(); --max_slots)
+        {
+            Slot &slot = old_slots[migrate_position];
+            if (slot.empty())
+            {
+                ++migrate_position;
+                continue;
+            }
+            // Removing the entry may shift the next entry into this slot, so do not advance.
+            // Entries are only ever shifted backwards, which keeps the slots before
+            // migrate_position empty
+            place(std::move(slot));
+            erase_at(old_slots, migrate_position);
+        }
+        if (migrate_position == old_slots.size())
+        {
+            std::vector<Slot>().swap(old_slots);
+            migrate_position = 0;
+        }
+    }
+
+    auto migrate_step() -> void
+    {
+        if (!old_slots.empty())
+            migrate(migrate_step_size);
+    }
+
     auto grow() -> void
     {
+        std::chrono::steady_clock::time_point start;
+        if constexpr (Stats::enabled)
+            start = std::chrono::steady_clock::now();
+
         size_t new_size;
         if (number_of_slots_total == 0)
             new_size = DEFAULT_START_BUCKETS_SIZE;
         else
-            new_size =
-                static_cast<size_t>(growth_factor_ * static_cast<float>(number_of_slots_total)) +
-                number_of_slots_total;
+            // At least one slot is added, as a small growth factor rounds down to 0 on a small
+            // table
+            new_size = number_of_slots_total +
+                       std::max<size_t>(1, static_cast<size_t>(
+                                               growth_factor_ *
+                                               static_cast<float>(number_of_slots_total)));
+        new_size = CapacityPolicy::round_up(new_size);
+
+        // Finish the previous resize, so that there are at most two tables
+        migrate(old_slots.size() + sz);
+
+        old_slots.resize(new_size);
+        std::swap(slots, old_slots);
+        std::swap(capacity_policy, old_capacity_policy);
+        capacity_policy.reset(new_size);
+        number_of_slots_total = new_size;
+        migrate_position = 0;
+        // Move all elements from the old table to the new one, or only the first few of them if
+        // the table is resized incrementally. A migration visits every old slot, and visits a
+        // slot once more for each entry moved out of it. That work is spread over the inserts
+        // left before the next grow, so that the next grow never has to finish the migration.
+        // insert_batch grows up to a block of keys early, so a block is not counted
+        if (rehash_step_ == 0)
+            migrate(old_slots.size() + sz);
+        else
+        {
+            auto limit = static_cast<size_t>(max_load_factor_ * static_cast<float>(new_size));
+            size_t inserts = limit > sz + BATCH_SIZE ? limit - sz - BATCH_SIZE : 1;
+            size_t work = old_slots.size() + sz;
+            migrate_step_size = std::max(rehash_step_, (work + inserts - 1) / inserts);
+            migrate(migrate_step_size);
+        }
 
-        std::vector<Slot> new_slots(new_size);
-        // Move all elements from the old table to the new one
-        for (size_t i = 0; i < slots.size(); ++i)
+        if constexpr (Stats::enabled)
+            this->stats_ref().record_grow(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Same as find_from, but only looks at the slots before end. Returns end if the key was not
+    // found there
+    template <typename K> auto find_before(const K &key, size_t index, size_t end) const -> size_t
+    {
+        for (size_t dist = 0; index < end; ++dist, ++index)
         {
-            if (slots[i].state == Slot::State::FILLED)
+            const Slot &slot = slots[index];
+            if (slot.empty() || slot.dist < dist)
+                return end;
+            if (slot.dist == dist && key_equal_(slot.k, key))
+                return index;
+        }
+        return end;
+    }
+
+    // Same as place, but no entry is moved to a slot at or after end. Returns false if an entry
+    // had to be moved past end, that entry is then left in entry. It may be a different entry than
+    // the one which was passed in
+    auto place_before(Slot &entry, size_t index, size_t end) -> bool
+    {
+        entry.dist = 0;
+        for (; index < end; ++index, ++entry.dist)
+        {
+            Slot &slot = slots[index];
+            if (slot.empty())
             {
-                auto new_index = hasher_(slots[i].k) % new_size;
-                new_slots[new_index] = slots[i];
+                slot = std::move(entry);
+                return true;
             }
+            if (slot.dist < entry.dist)
+                std::swap(slot, entry);
         }
-        std::swap(slots, new_slots);
+        return false;
+    }
+
+    // Moves every entry into a new table of new_size slots, and inserts the n pairs starting at
+    // first after them, as insert would.
+    // The new table is split into partitions of consecutive slots, which are filled in parallel
+    // (or one after the other if pool is nullptr). First the entries are distributed to the
+    // partition of their home slot, then each partition places its entries without writing
+    // outside of its slots, so no locks are needed. An entry which would be moved past the end
+    // of its partition is kept in a small overflow table, and placed after all partitions are
+    // done
+    template <typename RandomIt>
+    auto rebuild(size_t new_size, RandomIt first, size_t n, ThreadPool *pool) -> void
+    {
+        migrate(old_slots.size() + sz);
+        new_size = CapacityPolicy::round_up(new_size);
+        std::vector<Slot> previous(new_size);
+        std::swap(slots, previous);
+        capacity_policy.reset(new_size);
         number_of_slots_total = new_size;
+
+        auto run = [pool](size_t count, const auto &fn)
+        {
+            if (pool)
+                pool->parallel_for(count, fn);
+            else
+                for (size_t i = 0; i < count; ++i)
+                    fn(i);
+        };
+        size_t partitions = 1;
+        if (pool)
+            partitions = std::max<size_t>(
+                1, std::min(pool->size() * PARTITIONS_PER_THREAD, new_size / MIN_PARTITION_SIZE));
+        size_t partition_size = (new_size + partitions - 1) / partitions;
+
+        // Entries 0 to previous.size() - 1 are the slots of the previous table, the following ones
+        // are the pairs to insert. Chunk c of the entries lists its entries of partition p in
+        // lists[c][p], in order, so that the last value of a key wins
+        size_t total = previous.size() + n;
+        std::vector<std::vector<std::vector<size_t>>> lists(
+            partitions, std::vector<std::vector<size_t>>(partitions));
+        auto key_of = [&](size_t i) -> const Key &
+        {
+            return i < previous.size() ? previous[i].k : first[i - previous.size()].first;
+        };
+        run(partitions,
+            [&](size_t chunk)
+            {
+                size_t begin = total / partitions * chunk + std::min(chunk, total % partitions);
+                size_t end = begin + total / partitions + (chunk < total % partitions ? 1 : 0);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (i < previous.size() && previous[i].empty())
+                        continue;
+                    lists[chunk][home(key_of(i), capacity_policy) / partition_size].push_back(i);
+                }
+            });
+
+        std::vector<HashMap> overflows(partitions);
+        std::vector<size_t> added(partitions);
+        run(partitions,
+            [&](size_t partition)
+            {
+                size_t end = std::min(new_size, (partition + 1) * partition_size);
+                for (size_t chunk = 0; chunk < partitions; ++chunk)
+                    for (size_t i : lists[chunk][partition])
+                    {
+                        Slot entry;
+                        if (i < previous.size())
+                            entry = std::move(previous[i]);
+                        else
+                        {
+                            entry.k = first[i - previous.size()].first;
+                            entry.v = first[i - previous.size()].second;
+                        }
+                        auto index = home(entry.k, capacity_policy);
+                        auto found = find_before(entry.k, index, end);
+                        if (found != end)
+                        {
+                            slots[found].v = std::move(entry.v);
+                            continue;
+                        }
+                        if (auto value = overflows[partition].find_ptr(entry.k))
+                        {
+                            *value = std::move(entry.v);
+                            continue;
+                        }
+                        ++added[partition];
+                        if (!place_before(entry, index, end))
+                            overflows[partition].insert(entry.k, entry.v);
+                    }
+            });
+
+        // The keys of the overflow tables are all different, and none of them is in the table
+        sz = 0;
+        for (size_t partition = 0; partition < partitions; ++partition)
+        {
+            sz += added[partition];
+            for (Slot &entry : overflows[partition].slots)
+                if (!entry.empty())
+                    place(std::move(entry));
+        }
+    }
+
+    // Returns the smallest number of slots which keeps the load factor of n entries under the
+    // max load factor
+    auto slots_for(size_t n) const -> size_t
+    {
+        return static_cast<size_t>(static_cast<float>(n) / max_load_factor_) + 1;
     }
 
   public:
@@ -81,85 +725,236 @@ class HashMap
     static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.7f;
     static constexpr float DEFAULT_GROWTH_FACTOR = 1.0f;
     static constexpr size_t DEFAULT_START_BUCKETS_SIZE = 8;
+    static constexpr size_t BATCH_SIZE = 16;
+    // A parallel rebuild splits the table into this many partitions per thread of the pool, with
+    // at least MIN_PARTITION_SIZE slots each
+    static constexpr size_t PARTITIONS_PER_THREAD = 4;
+    static constexpr size_t MIN_PARTITION_SIZE = 4096;
 
     // using value_type = std::pair<const Key, Value>;
     // using reference = value_type &;
     // using const_reference = const value_type &;
 
     HashMap()
-        : sz(0), number_of_slots_used(0), number_of_slots_total(0),
-          max_load_factor_(DEFAULT_MAX_LOAD_FACTOR), growth_factor_(DEFAULT_GROWTH_FACTOR)
+        : sz(0), number_of_slots_total(0), max_load_factor_(DEFAULT_MAX_LOAD_FACTOR),
+          growth_factor_(DEFAULT_GROWTH_FACTOR), migrate_position(0), rehash_step_(0),
+          migrate_step_size(0)
     {
     }
 
+    auto find(const Key &key) const -> std::optional<Value> { return find_value(key); }
+
+    // Same as the const version, but also moves a few entries if the table is being resized
     auto find(const Key &key) -> std::optional<Value>
     {
-        auto index = hasher_(key) % number_of_slots_total;
-        // TODO: Implement wrap around
-        while (index < number_of_slots_total)
+        migrate_step();
+        return find_value(key);
+    }
+
+    // Returns a pointer to the value of the key, or nullptr if the key does not exist. Unlike find,
+    // the value is not copied. The pointer is valid until the table is modified
+    auto find_ptr(const Key &key) const -> const Value * { return find_value_ptr(key); }
+
+    auto find_ptr(const Key &key) -> Value *
+    {
+        migrate_step();
+        return const_cast<Value *>(find_value_ptr(key));
+    }
+
+    // Heterogeneous lookup, these overloads are only available if both Hash and KeyEqual declare
+    // is_transparent (see StringHash in hash.hpp). The key can then be of any type which they can
+    // hash and compare with Key, for example a std::string_view for std::string keys, and no Key
+    // is constructed
+    template <typename K, typename = if_transparent<K>>
+    auto find(const K &key) const -> std::optional<Value>
+    {
+        return find_value(key);
+    }
+
+    template <typename K, typename = if_transparent<K>>
+    auto find(const K &key) -> std::optional<Value>
+    {
+        migrate_step();
+        return find_value(key);
+    }
+
+    template <typename K, typename = if_transparent<K>>
+    auto find_ptr(const K &key) const -> const Value *
+    {
+        return find_value_ptr(key);
+    }
+
+    template <typename K, typename = if_transparent<K>> auto find_ptr(const K &key) -> Value *
+    {
+        migrate_step();
+        return const_cast<Value *>(find_value_ptr(key));
+    }
+
+    template <typename K, typename = if_transparent<K>> auto contains(const K &key) const -> bool
+    {
+        return recorded_lookup(key) != nullptr;
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        migrate_step();
+        // Overwrite the value if there is an existing key
+        if (auto slot = lookup(key))
         {
-            if (slots[index].state == Slot::State::FILLED && slots[index].k == key)
-            {
-                return slots[index].v;
-            }
-            ++index;
+            slot->v = value;
+            return;
         }
-        return std::nullopt;
+        insert_new(key, value);
     }
 
-    auto insert(const Key &key, const Value &value) -> void
+    // Calls fn with a reference to the value of the key, so that it can be updated in place. If
+    // the key does not exist, a default constructed value is inserted first
+    template <typename Fn> auto upsert(const Key &key, Fn fn) -> void
     {
-        if (number_of_slots_total == 0 || load_factor() >= max_load_factor())
-            grow();
+        migrate_step();
+        if (auto slot = lookup(key))
+        {
+            fn(slot->v);
+            return;
+        }
+        fn(slots[insert_new(key, Value())].v);
+    }
 
-        // Perform linear probing until a free slot is found
-        size_t index = 0;
-        while (true)
+    auto erase(const Key &key) -> void
+    {
+        migrate_step();
+        auto index = find_index(key);
+        if (index != number_of_slots_total)
+            erase_at(slots, index);
+        else if ((index = find_in(old_slots, old_capacity_policy, key)) != old_slots.size())
+            erase_at(old_slots, index);
+        else
+            return;
+        --sz;
+    }
+
+    auto contains(const Key &key) const -> bool { return recorded_lookup(key) != nullptr; }
+
+    // Looks up n keys, and stores a pointer to the value of keys[i] in out[i], or nullptr if the
+    // key does not exist. The pointers are valid until the table is modified.
+    // The keys are processed in blocks of BATCH_SIZE, the home slots of a whole block are computed
+    // and prefetched before any of them are probed, so that the cache misses overlap
+    auto find_batch(const Key *keys, size_t n, Value **out) -> void
+    {
+        migrate_step();
+        size_t homes[BATCH_SIZE];
+        for (size_t base = 0; base < n; base += BATCH_SIZE)
         {
-            index = hasher_(key) % number_of_slots_total;
-            while (index < number_of_slots_total)
+            size_t count = std::min(BATCH_SIZE, n - base);
+            if (sz == 0)
             {
-                // Overwrite the value if there is an existing key
-                if (slots[index].state == Slot::State::FILLED && slots[index].k == key)
-                {
-                    slots[index].v = value;
-                    return;
-                }
-                if (slots[index].state == Slot::State::EMPTY)
-                    break;
-                ++index;
+                std::fill(out + base, out + base + count, nullptr);
+                continue;
             }
-            // TODO: Also wrap around and check
-            if (index >= number_of_slots_total)
+            for (size_t i = 0; i < count; ++i)
             {
-                // No free slot was found, grow the table and try again
+                homes[i] = home(keys[base + i], capacity_policy);
+                __builtin_prefetch(&slots[homes[i]]);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Key &key = keys[base + i];
+                size_t probes = 0;
+                auto index = find_from(slots, key, homes[i], probes);
+                if (index != number_of_slots_total)
+                    out[base + i] = &slots[index].v;
+                else if ((index = find_in(old_slots, old_capacity_policy, key, probes)) !=
+                         old_slots.size())
+                    out[base + i] = &old_slots[index].v;
+                else
+                    out[base + i] = nullptr;
+                if constexpr (Stats::enabled)
+                    this->stats_ref().record_find(probes, out[base + i] != nullptr);
+            }
+        }
+    }
+
+    // Inserts (or updates) n key-value pairs, keys[i] is mapped to values[i]. As with find_batch,
+    // the home slots of a block of keys are prefetched before they are probed. The table is grown
+    // before a block is processed, so that the prefetched slots stay valid
+    auto insert_batch(const Key *keys, const Value *values, size_t n) -> void
+    {
+        size_t homes[BATCH_SIZE];
+        for (size_t base = 0; base < n; base += BATCH_SIZE)
+        {
+            size_t count = std::min(BATCH_SIZE, n - base);
+            // One step for each key, as if they were inserted one by one
+            if (!old_slots.empty())
+                migrate(count * migrate_step_size);
+            // A small table may need more than one grow to fit a block under the max load
+            // factor. There must also be an empty slot left for every key
+            while (number_of_slots_total == 0 ||
+                   static_cast<float>(sz + count) >
+                       max_load_factor_ * static_cast<float>(number_of_slots_total) ||
+                   sz + count >= number_of_slots_total)
                 grow();
+            for (size_t i = 0; i < count; ++i)
+            {
+                homes[i] = home(keys[base + i], capacity_policy);
+                __builtin_prefetch(&slots[homes[i]], 1);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Key &key = keys[base + i];
+                auto index = find_from(slots, key, homes[i]);
+                if (index != number_of_slots_total)
+                    slots[index].v = values[base + i];
+                else if ((index = find_in(old_slots, old_capacity_policy, key)) != old_slots.size())
+                    old_slots[index].v = values[base + i];
+                else
+                {
+                    Slot entry;
+                    entry.k = key;
+                    entry.v = values[base + i];
+                    place(std::move(entry), homes[i]);
+                    ++sz;
+                }
             }
-            else
-                break;
         }
+    }
 
-        // We found an empty slot
-        slots[index].k = key;
-        slots[index].v = value;
-        slots[index].state = Slot::State::FILLED;
-        ++number_of_slots_used;
-        ++sz;
+    // Inserts (or updates) the key-value pairs of [first, last), as calling insert for each of them
+    // in order would. The table is resized once to fit all of them, and rebuilt with the entries
+    // which were already in it. With a pool, the table is built in parallel (see rebuild)
+    template <typename RandomIt> auto bulk_build(RandomIt first, RandomIt last) -> void
+    {
+        bulk_build(first, last, nullptr);
     }
 
-    auto erase(const Key &key) -> void {}
+    template <typename RandomIt>
+    auto bulk_build(RandomIt first, RandomIt last, ThreadPool &pool) -> void
+    {
+        bulk_build(first, last, &pool);
+    }
 
-    auto contains(const Key &key) const -> bool {}
+    // Resizes the table to at least n slots, or to the number of slots the current entries need
+    // under the max load factor if that is larger. With a pool, the entries are moved in parallel
+    auto rehash(size_type n) -> void { rehash(n, nullptr); }
+
+    auto rehash(size_type n, ThreadPool &pool) -> void { rehash(n, &pool); }
 
     auto size() const -> size_type { return sz; }
 
-    auto clear() -> void {}
+    // Returns the number of slots in the table
+    auto capacity() const -> size_type { return number_of_slots_total; }
+
+    auto clear() -> void
+    {
+        std::fill(slots.begin(), slots.end(), Slot());
+        std::vector<Slot>().swap(old_slots);
+        migrate_position = 0;
+        sz = 0;
+    }
 
     auto load_factor() const -> float
     {
         if (number_of_slots_total)
-            return static_cast<float>(number_of_slots_used) /
-                   static_cast<float>(number_of_slots_total);
+            return static_cast<float>(sz) / static_cast<float>(number_of_slots_total);
         return 0;
     }
 
@@ -167,7 +962,8 @@ class HashMap
 
     auto max_load_factor(float new_max_load_factor) -> void
     {
-        if (new_max_load_factor > 1.0f || new_max_load_factor < 0.0f)
+        // slots_for divides by the max load factor, so 0 (and NaN) are rejected
+        if (!(new_max_load_factor > 0.0f && new_max_load_factor <= 1.0f))
             throw std::logic_error("Invalid Max load factor, it should be between 0 and 1");
         max_load_factor_ = new_max_load_factor;
     }
@@ -180,6 +976,129 @@ class HashMap
             throw std::logic_error("Growth factor is greater than 1");
         growth_factor_ = new_growth_factor;
     }
+
+    auto rehash_step() const -> size_type { return rehash_step_; }
+
+    // Sets the number of slots of the old table which are moved on each insert, find and erase
+    // after the table grows. Setting it to 0 (the default) moves all entries in the insert which
+    // grows the table. A step too small for the move to end before the table grows again is
+    // raised to the smallest one which does
+    auto rehash_step(size_type new_rehash_step) -> void { rehash_step_ = new_rehash_step; }
+
+    // Returns true if the table is being resized incrementally, and some entries are still in the
+    // old table
+    auto is_rehashing() const -> bool { return !old_slots.empty(); }
+
+    // Writes the table to a file, which can be opened with MappedHashMap. The hash function has to
+    // give the same results in the process which opens the file. Any incremental resize is
+    // completed first
+    auto save(const std::string &path) -> void
+    {
+        static_assert(std::is_trivially_copyable<Key>::value &&
+                          std::is_trivially_copyable<Value>::value,
+                      "Only tables with trivially copyable keys and values can be saved");
+        migrate(old_slots.size() + sz);
+
+        HashMapSnapshotHeader header = {};
+        header.magic = HashMapSnapshotHeader::MAGIC;
+        header.version = HashMapSnapshotHeader::VERSION;
+        header.slot_size = sizeof(Slot);
+        header.key_size = sizeof(Key);
+        header.value_size = sizeof(Value);
+        header.size = sz;
+        header.capacity = number_of_slots_total;
+        header.slots_offset = HashMapSnapshotHeader::SLOTS_OFFSET;
+        header.capacity_policy = capacity_policy_tag<CapacityPolicy>::value;
+        header.hash_fingerprint = hash_fingerprint<Key>(hasher_);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Could not open " + path + " for writing");
+        char padding[HashMapSnapshotHeader::SLOTS_OFFSET] = {};
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(padding, HashMapSnapshotHeader::SLOTS_OFFSET - sizeof(header));
+        out.write(reinterpret_cast<const char *>(slots.data()),
+                  static_cast<std::streamsize>(slots.size() * sizeof(Slot)));
+        if (!out)
+            throw std::runtime_error("Could not write to " + path);
+    }
+
+    auto stats() const -> const Stats & { return this->stats_ref(); }
+
+  private:
+    template <typename RandomIt>
+    auto bulk_build(RandomIt first, RandomIt last, ThreadPool *pool) -> void
+    {
+        using category = typename std::iterator_traits<RandomIt>::iterator_category;
+        static_assert(std::is_base_of<std::random_access_iterator_tag, category>::value,
+                      "bulk_build requires random access iterators");
+        auto n = static_cast<size_t>(std::distance(first, last));
+        rebuild(std::max(number_of_slots_total, slots_for(sz + n)), first, n, pool);
+    }
+
+    auto rehash(size_type n, ThreadPool *pool) -> void
+    {
+        const std::pair<Key, Value> *none = nullptr;
+        rebuild(std::max(n, slots_for(sz)), none, 0, pool);
+    }
+
+  public:
+
+    auto reset_stats() -> void { this->stats_ref().reset(); }
+
+    // Prints the shape of the table, and the collected statistics if Stats is HashMapStats
+    auto dump_stats(std::ostream &os = std::cout) const -> void
+    {
+        size_t max_displacement = 0, total_displacement = 0;
+        for (const auto *table : {&slots, &old_slots})
+            for (const Slot &slot : *table)
+                if (!slot.empty())
+                {
+                    max_displacement = std::max<size_t>(max_displacement, slot.dist);
+                    total_displacement += slot.dist;
+                }
+
+        os << "Size: " << sz << ", capacity: " << number_of_slots_total
+           << ", load factor: " << load_factor() << std::endl;
+        os << "Displacement: max " << max_displacement << ", mean "
+           << (sz ? static_cast<double>(total_displacement) / static_cast<double>(sz) : 0.0)
+           << std::endl;
+        // Erased entries are removed with backward shift deletion, no tombstones are left behind
+        os << "Tombstone ratio: 0" << std::endl;
+        if constexpr (Stats::enabled)
+        {
+            const Stats &stats = this->stats_ref();
+            os << "Max displacement on insert: " << stats.max_displacement << std::endl;
+            double total = 0, longest = 0;
+            for (auto seconds : stats.grow_seconds)
+            {
+                total += seconds;
+                longest = std::max(longest, seconds);
+            }
+            os << "Grow calls: " << stats.grow_seconds.size() << ", total " << total * 1e3
+               << " ms, longest " << longest * 1e3 << " ms" << std::endl;
+
+            auto print_histogram = [&os](const char *name, const auto &histogram)
+            {
+                uint64_t count = 0, weighted = 0;
+                for (size_t i = 0; i < histogram.size(); ++i)
+                {
+                    count += histogram[i];
+                    weighted += histogram[i] * i;
+                }
+                os << name << ": " << count << " finds, mean probe length "
+                   << (count ? static_cast<double>(weighted) / static_cast<double>(count) : 0.0)
+                   << std::endl;
+                for (size_t i = 0; i < histogram.size(); ++i)
+                    if (histogram[i])
+                        os << "    " << std::setw(3) << i
+                           << (i + 1 == histogram.size() ? "+" : " ") << " | " << histogram[i]
+                           << std::endl;
+            };
+            print_histogram("Hits", stats.hit_probe_lengths);
+            print_histogram("Misses", stats.miss_probe_lengths);
+        }
+    }
 };
 
 #endif // A_HASHMAP_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+// A priority queue of integer handles, where the priority of any element can be changed or the
+// element removed in O(log n), for algorithms such as Dijkstra's shortest paths
+//
+// Unlike PriorityQueue, the top is the smallest priority under Compare, so that decrease_key moves
+// an element towards the top. The handles are dense integers, the heap index of every handle is
+// kept in a flat array indexed by the handle, which grows to the largest handle pushed
+template <typename Priority, typename Compare = std::less<Priority>, size_t Arity = 2>
+class IndexedPriorityQueue
+{
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+
+  public:
+    typedef size_t handle_type;
+    typedef Priority priority_type;
+    typedef size_t size_type;
+    typedef Compare value_compare;
+    static constexpr size_t NPOS = SIZE_MAX;
+
+  private:
+    // The d-ary heap of PriorityQueue, see detail::DaryHeap. The priorities are stored in the heap
+    // next to their handles, so comparisons do not go through the handle. Every move of an entry
+    // updates the position of its handle
+    struct Entry
+    {
+        Priority priority;
+        size_t handle;
+    };
+
+    // DaryHeap keeps the largest entry on top, so the entries are compared in reverse
+    struct EntryCompare
+    {
+        Compare comp;
+
+        bool operator()(const Entry &a, const Entry &b) { return comp(b.priority, a.priority); }
+    };
+
+    // Moves an entry into a slot of the heap, and records the position of its handle
+    struct PlaceEntry
+    {
+        std::vector<size_t> *positions;
+
+        void operator()(Entry *heap, size_t i, Entry &&entry) const
+        {
+            (*positions)[entry.handle] = i;
+            heap[i] = std::move(entry);
+        }
+    };
+
+    typedef detail::DaryHeap<Arity> Heap;
+
+    std::vector<Entry> heap;
+    // positions[handle] is the index of the handle in heap, or NPOS
+    std::vector<size_t> positions;
+    EntryCompare comp;
+
+    void sift_up(size_t i) { Heap::sift_up(heap.data(), i, comp, PlaceEntry{&positions}); }
+
+    void sift_down(size_t i)
+    {
+        Heap::sift_down(heap.data(), heap.size(), i, std::move(heap[i]), comp,
+                        PlaceEntry{&positions});
+    }
+
+    size_t position_of(handle_type handle)
+    {
+        if (!contains(handle))
+            throw std::logic_error("The handle is not in the priority queue");
+        return positions[handle];
+    }
+
+  public:
+    IndexedPriorityQueue() {}
+
+    // Reserves room for the handles 0 to capacity - 1
+    explicit IndexedPriorityQueue(size_t capacity, const Compare &compare = Compare())
+        : positions(capacity, NPOS), comp{compare}
+    {
+        heap.reserve(capacity);
+    }
+
+    size_type size() const { return heap.size(); }
+
+    bool empty() const { return heap.empty(); }
+
+    bool contains(handle_type handle) const
+    {
+        return handle < positions.size() && positions[handle] != NPOS;
+    }
+
+    handle_type top_handle() const { return heap.front().handle; }
+
+    const priority_type &top_priority() const { return heap.front().priority; }
+
+    const priority_type &priority(handle_type handle) const
+    {
+        if (!contains(handle))
+            throw std::logic_error("The handle is not in the priority queue");
+        return heap[positions[handle]].priority;
+    }
+
+    void push(handle_type handle, priority_type priority)
+    {
+        if (contains(handle))
+            throw std::logic_error("The handle is already in the priority queue");
+        if (handle >= positions.size())
+            positions.resize(std::max(handle + 1, positions.size() * 2), NPOS);
+        heap.push_back(Entry{std::move(priority), handle});
+        positions[handle] = heap.size() - 1;
+        sift_up(heap.size() - 1);
+    }
+
+    void pop()
+    {
+        positions[heap.front().handle] = NPOS;
+        if (heap.size() > 1)
+        {
+            heap.front() = std::move(heap.back());
+            heap.pop_back();
+            sift_down(0);
+        }
+        else
+            heap.pop_back();
+    }
+
+    // Removes the handle from the queue
+    void erase(handle_type handle)
+    {
+        size_t i = position_of(handle);
+        positions[handle] = NPOS;
+        if (i + 1 == heap.size())
+        {
+            heap.pop_back();
+            return;
+        }
+        // The last entry takes the place of the erased one, and may have to move either way
+        PlaceEntry{&positions}(heap.data(), i, std::move(heap.back()));
+        heap.pop_back();
+        if (i > 0 && comp(heap[Heap::parent(i)], heap[i]))
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    // Sets a priority which is not greater than the current one, moving the handle towards the top
+    void decrease_key(handle_type handle, priority_type priority)
+    {
+        size_t i = position_of(handle);
+        if (comp.comp(heap[i].priority, priority))
+            throw std::logic_error("decrease_key was given a greater priority");
+        heap[i].priority = std::move(priority);
+        sift_up(i);
+    }
+
+    // Sets a priority which is not smaller than the current one, moving the handle away from the
+    // top
+    void increase_key(handle_type handle, priority_type priority)
+    {
+        size_t i = position_of(handle);
+        if (comp.comp(priority, heap[i].priority))
+            throw std::logic_error("increase_key was given a smaller priority");
+        heap[i].priority = std::move(priority);
+        sift_down(i);
+    }
+
+    // Sets the priority of the handle, in either direction
+    void update(handle_type handle, priority_type priority)
+    {
+        size_t i = position_of(handle);
+        bool up = comp.comp(priority, heap[i].priority);
+        heap[i].priority = std::move(priority);
+        if (up)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    void clear()
+    {
+        for (const Entry &entry : heap)
+            positions[entry.handle] = NPOS;
+        heap.clear();
+    }
+};
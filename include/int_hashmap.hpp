@@ -0,0 +1,212 @@
+#ifndef A_INT_HASHMAP_H
+#define A_INT_HASHMAP_H
+#include "hashmap.hpp"
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+/*
+ * IntHashMap
+ * ==========
+ * A hash table specialized for integer keys, for tables such as integer ID lookups
+ * Design choices
+ * 1) A slot is only a key and a value, there is no state and no probe distance. An empty slot is
+ * one whose key is EmptyKey, a value which is reserved at compile time (the largest value of Key
+ * by default) and can not be inserted. A lookup compares only keys, without HashMap's check of
+ * the probe distance. When the key and the value leave no padding for the 4 byte distance of
+ * HashMap, the slot is also smaller: IntHashMap<uint64_t, uint64_t> takes 16 bytes per slot where
+ * HashMap takes 24, and IntHashMap<uint32_t, uint32_t> takes 8 where HashMap takes 12
+ * 2) Linear probing over a power of two number of slots, with Fibonacci hashing of the key (see
+ * PowerOfTwoCapacity in hashmap.hpp), so no division and no weak hash clustering
+ * 3) erase() uses backward shift deletion (Knuth's Algorithm R): following entries which would
+ * become unreachable are moved back into the hole. So no deleted marker is needed, and only one
+ * key value is reserved
+ * 4) When the table grows, the new slots are initialized in bulk with memset if every byte of
+ * EmptyKey is the same (as it is for the default of unsigned keys), or key by key otherwise
+ * 5) Key must be an integral type and Value must be trivially copyable
+ */
+template <typename Key, typename Value, Key EmptyKey = std::numeric_limits<Key>::max()>
+class IntHashMap
+{
+    static_assert(std::is_integral<Key>::value, "IntHashMap requires an integral key");
+    static_assert(std::is_trivially_copyable<Value>::value,
+                  "IntHashMap requires a trivially copyable value");
+
+  private:
+    struct Slot
+    {
+        Key k;
+        Value v;
+
+        // Leave the slot uninitialized, the table initializes all slots in bulk
+        Slot() {}
+    };
+
+    size_t sz, mask;
+    float max_load_factor_;
+    PowerOfTwoCapacity capacity_policy;
+    std::vector<Slot> slots;
+
+    // Returns true if all bytes of EmptyKey are equal, so that memset can write it
+    static auto empty_key_is_byte_pattern() -> bool
+    {
+        Key key = EmptyKey;
+        unsigned char bytes[sizeof(Key)];
+        std::memcpy(bytes, &key, sizeof(Key));
+        for (size_t i = 1; i < sizeof(Key); ++i)
+            if (bytes[i] != bytes[0])
+                return false;
+        return true;
+    }
+
+    static auto mark_empty(Slot *first, size_t n) -> void
+    {
+        if (empty_key_is_byte_pattern())
+        {
+            Key key = EmptyKey;
+            unsigned char byte;
+            std::memcpy(&byte, &key, 1);
+            // Sets the values too, which is fine as Value is trivially copyable
+            std::memset(static_cast<void *>(first), byte, n * sizeof(Slot));
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                first[i].k = EmptyKey;
+        }
+    }
+
+    auto home(Key key) const -> size_t
+    {
+        return capacity_policy.index(static_cast<size_t>(key));
+    }
+
+    // Returns the index of the slot holding key, or slots.size()
+    auto find_index(Key key) const -> size_t
+    {
+        if (sz == 0 || key == EmptyKey)
+            return slots.size();
+        for (auto index = home(key);; index = (index + 1) & mask)
+        {
+            if (slots[index].k == key)
+                return index;
+            if (slots[index].k == EmptyKey)
+                return slots.size();
+        }
+    }
+
+    auto place(Key key, Value value) -> void
+    {
+        auto index = home(key);
+        while (slots[index].k != EmptyKey)
+            index = (index + 1) & mask;
+        slots[index].k = key;
+        slots[index].v = value;
+    }
+
+    auto grow() -> void
+    {
+        size_t new_size = slots.empty() ? DEFAULT_START_BUCKETS_SIZE : slots.size() * 2;
+        std::vector<Slot> old_slots(new_size);
+        mark_empty(old_slots.data(), new_size);
+        std::swap(slots, old_slots);
+        mask = new_size - 1;
+        capacity_policy.reset(new_size);
+        for (const Slot &slot : old_slots)
+            if (slot.k != EmptyKey)
+                place(slot.k, slot.v);
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    static constexpr Key EMPTY_KEY = EmptyKey;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.7f;
+    static constexpr size_t DEFAULT_START_BUCKETS_SIZE = 8;
+
+    IntHashMap() : sz(0), mask(0), max_load_factor_(DEFAULT_MAX_LOAD_FACTOR) {}
+
+    auto find(Key key) const -> std::optional<Value>
+    {
+        auto index = find_index(key);
+        if (index == slots.size())
+            return std::nullopt;
+        return slots[index].v;
+    }
+
+    auto insert(Key key, Value value) -> void
+    {
+        if (key == EmptyKey)
+            throw std::logic_error("The empty key can not be inserted into IntHashMap");
+        // Overwrite the value if there is an existing key
+        auto index = find_index(key);
+        if (index != slots.size())
+        {
+            slots[index].v = value;
+            return;
+        }
+        if (slots.empty() ||
+            static_cast<float>(sz + 1) > max_load_factor_ * static_cast<float>(slots.size()))
+            grow();
+        place(key, value);
+        ++sz;
+    }
+
+    auto erase(Key key) -> void
+    {
+        auto hole = find_index(key);
+        if (hole == slots.size())
+            return;
+        // Move back every following entry of the cluster whose home slot is not between the hole
+        // and its current slot, as it would not be reachable anymore
+        for (auto index = (hole + 1) & mask; slots[index].k != EmptyKey; index = (index + 1) & mask)
+        {
+            auto h = home(slots[index].k);
+            bool reachable = hole <= index ? (hole < h && h <= index) : (hole < h || h <= index);
+            if (!reachable)
+            {
+                slots[hole] = slots[index];
+                hole = index;
+            }
+        }
+        slots[hole].k = EmptyKey;
+        --sz;
+    }
+
+    auto contains(Key key) const -> bool { return find_index(key) != slots.size(); }
+
+    auto size() const -> size_type { return sz; }
+
+    auto empty() const -> bool { return sz == 0; }
+
+    auto capacity() const -> size_type { return slots.size(); }
+
+    auto clear() -> void
+    {
+        mark_empty(slots.data(), slots.size());
+        sz = 0;
+    }
+
+    auto load_factor() const -> float
+    {
+        if (slots.size())
+            return static_cast<float>(sz) / static_cast<float>(slots.size());
+        return 0;
+    }
+
+    auto max_load_factor() const -> float { return max_load_factor_; }
+
+    auto max_load_factor(float new_max_load_factor) -> void
+    {
+        if (new_max_load_factor >= 1.0f || new_max_load_factor <= 0.0f)
+            throw std::logic_error("Invalid Max load factor, it should be between 0 and 1");
+        max_load_factor_ = new_max_load_factor;
+    }
+};
+
+#endif // A_INT_HASHMAP_H
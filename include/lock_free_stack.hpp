@@ -0,0 +1,251 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// A stack which many threads can push to and pop from without locks (a Treiber stack), for shared
+// free lists and pools of work
+//
+// The stack is a linked list, and push and pop replace its head with a compare and swap. A popping
+// thread reads the next pointer of the head before its compare and swap, while another thread may
+// pop and free the same node. The nodes are freed with hazard pointers, which prevents this:
+//     * Before reading a node, a popping thread publishes its address in a hazard slot, then checks
+//       that the node is still the head
+//     * A popped node is not freed at once but retired, and the retired nodes are freed in batches,
+//       skipping the nodes which are published in any slot
+// A node cannot be freed and allocated again while a thread holds it in a slot, so the head never
+// changes from a node to another one and back to the same node between the read and the compare
+// and swap of a pop (the ABA problem) and the head needs no tag
+//
+// The hazard slots of a stack are in a list, and try_pop takes a free slot for the length of one
+// pop. When every slot is in use, it adds a new slot to the list instead of waiting for one, so a
+// pop never waits for another thread, and there are at most as many slots as threads which ever
+// popped at the same time. The retired nodes are kept by the slot, not by the thread, so a thread
+// needs no registration, and a thread which ends leaves nothing behind. A batch also takes over the
+// retired nodes of the slots which are not in use, so that nodes retired into a slot which is not
+// taken again are still freed
+template <typename T> class LockFreeStack
+{
+  private:
+    struct Node
+    {
+        T value;
+        Node *next;
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic<Node *> hazard{nullptr};
+        std::atomic<bool> busy{false};
+        // Set before the slot is added to the list, and never changed
+        Slot *next = nullptr;
+        // Only used by the thread which holds the slot
+        std::vector<Node *> retired;
+    };
+
+    alignas(64) std::atomic<Node *> head;
+    // Slots are only ever added in front of the list, and freed by the destructor
+    std::atomic<Slot *> slots;
+    std::atomic<size_t> number_of_slots;
+
+    static bool try_take(Slot &slot)
+    {
+        return !slot.busy.load(std::memory_order_relaxed) &&
+               !slot.busy.exchange(true, std::memory_order_acquire);
+    }
+
+    void add_slot(Slot *slot)
+    {
+        slot->next = slots.load(std::memory_order_relaxed);
+        while (!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                            std::memory_order_relaxed))
+            ;
+        number_of_slots.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Takes the first free slot, or adds a taken slot to the list if none is free
+    Slot &acquire_slot()
+    {
+        for (Slot *slot = slots.load(std::memory_order_acquire); slot; slot = slot->next)
+            if (try_take(*slot))
+                return *slot;
+        Slot *slot = new Slot;
+        slot->busy.store(true, std::memory_order_relaxed);
+        add_slot(slot);
+        return *slot;
+    }
+
+    // Takes over the retired nodes of the free slots, then frees the retired nodes of the slot
+    // which are not published in any slot
+    void scan(Slot &own)
+    {
+        for (Slot *slot = slots.load(std::memory_order_acquire); slot; slot = slot->next)
+            if (slot != &own && try_take(*slot))
+            {
+                own.retired.insert(own.retired.end(), slot->retired.begin(), slot->retired.end());
+                slot->retired.clear();
+                slot->busy.store(false, std::memory_order_release);
+            }
+        // Orders the unlinking compare and swap in try_pop before the loads of the hazards below,
+        // pairing with the store of the hazard and the load of the head in try_pop. Without it,
+        // a hazard published just before its node is unlinked could be missed
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::vector<Node *> hazards;
+        for (Slot *slot = slots.load(std::memory_order_acquire); slot; slot = slot->next)
+            if (Node *node = slot->hazard.load(std::memory_order_seq_cst))
+                hazards.push_back(node);
+        std::sort(hazards.begin(), hazards.end());
+        auto free_if_safe = [&hazards](Node *node)
+        {
+            if (std::binary_search(hazards.begin(), hazards.end(), node))
+                return false;
+            delete node;
+            return true;
+        };
+        own.retired.erase(std::remove_if(own.retired.begin(), own.retired.end(), free_if_safe),
+                          own.retired.end());
+    }
+
+    // Links the chain [first, last] in front of the head with a single compare and swap
+    void push_chain(Node *first, Node *last)
+    {
+        last->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(last->next, first, std::memory_order_release,
+                                           std::memory_order_relaxed))
+            ;
+    }
+
+  public:
+    typedef T value_type;
+    static constexpr size_t DEFAULT_NUMBER_OF_SLOTS = 128;
+
+    // Starts with slot_count slots, enough for as many threads to pop at the same time before a
+    // new slot is allocated
+    explicit LockFreeStack(size_t slot_count = DEFAULT_NUMBER_OF_SLOTS)
+        : head(nullptr), slots(nullptr), number_of_slots(0)
+    {
+        for (size_t i = 0; i < std::max<size_t>(1, slot_count); ++i)
+            add_slot(new Slot);
+    }
+
+    LockFreeStack(const LockFreeStack &) = delete;
+
+    LockFreeStack &operator=(const LockFreeStack &) = delete;
+
+    // Must not run at the same time as any other operation
+    ~LockFreeStack()
+    {
+        for (Node *node = head.load(std::memory_order_relaxed); node;)
+        {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        for (Slot *slot = slots.load(std::memory_order_relaxed); slot;)
+        {
+            for (Node *node : slot->retired)
+                delete node;
+            Slot *next = slot->next;
+            delete slot;
+            slot = next;
+        }
+    }
+
+    void push(const T &value)
+    {
+        Node *node = new Node{value, nullptr};
+        push_chain(node, node);
+    }
+
+    void push(T &&value)
+    {
+        Node *node = new Node{std::move(value), nullptr};
+        push_chain(node, node);
+    }
+
+    // Pushes the elements of [first, last), the last one ends up on top. The nodes are linked
+    // before they are published, so the whole batch costs one compare and swap on the head
+    template <typename InputIt> void push_bulk(InputIt first, InputIt last)
+    {
+        if (first == last)
+            return;
+        Node *bottom = new Node{*first, nullptr};
+        Node *top = bottom;
+        try
+        {
+            for (++first; first != last; ++first)
+                top = new Node{*first, top};
+        }
+        catch (...)
+        {
+            // Nothing is published yet, free the nodes linked so far
+            while (top)
+            {
+                Node *next = top->next;
+                delete top;
+                top = next;
+            }
+            throw;
+        }
+        push_chain(top, bottom);
+    }
+
+    // Pops the top into out. Returns false if the stack is empty
+    bool try_pop(T &out)
+    {
+        // Releases the slot on every return, and when moving the value out throws
+        struct Release
+        {
+            Slot &slot;
+
+            ~Release() { slot.busy.store(false, std::memory_order_release); }
+        };
+        Slot &slot = acquire_slot();
+        Release release{slot};
+        Node *node = head.load(std::memory_order_acquire);
+        while (node)
+        {
+            // Once the node is published and still the head, it can not be freed
+            slot.hazard.store(node, std::memory_order_seq_cst);
+            Node *current = head.load(std::memory_order_seq_cst);
+            if (current != node)
+            {
+                node = current;
+                continue;
+            }
+            if (head.compare_exchange_strong(node, node->next, std::memory_order_seq_cst,
+                                             std::memory_order_acquire))
+                break;
+        }
+        slot.hazard.store(nullptr, std::memory_order_release);
+        if (node)
+        {
+            // Retired first, so that the node is still freed if moving the value out throws. Only
+            // a scan of this slot, which is held until the end of the pop, could free it
+            slot.retired.push_back(node);
+            out = std::move(node->value);
+            if (slot.retired.size() >= 2 * number_of_slots.load(std::memory_order_relaxed))
+                scan(slot);
+        }
+        return node != nullptr;
+    }
+
+    // The stack may no longer be empty, or may be empty, when this returns
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    // The number of hazard slots, which grows when more threads pop at the same time than there
+    // are slots
+    size_t slot_count() const { return number_of_slots.load(std::memory_order_relaxed); }
+
+    // The number of popped nodes which are not freed yet. Must not run at the same time as any
+    // other operation
+    size_t retired_count() const
+    {
+        size_t count = 0;
+        for (Slot *slot = slots.load(std::memory_order_relaxed); slot; slot = slot->next)
+            count += slot->retired.size();
+        return count;
+    }
+};
@@ -0,0 +1,182 @@
+#ifndef A_MAPPED_HASHMAP_H
+#define A_MAPPED_HASHMAP_H
+#include "hashmap.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <optional>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+/*
+ * MappedHashMap
+ * =============
+ * A read only view of a HashMap which was written to a file with HashMap::save(path)
+ * Design choices
+ * 1) The file is mapped into memory with mmap, and lookups run directly on the mapped slots. There
+ * is no deserialization, so opening a table is O(1) and the pages are loaded as they are touched.
+ * Processes which open the same file share its pages through the page cache
+ * 2) The template arguments must be the same as the ones of the HashMap which was saved. The
+ * header of the file records the sizes of the key, the value and the slot, the capacity policy
+ * and a fingerprint of the hash function, and open_mapped throws if they do not match
+ * 3) Requires a POSIX system (mmap)
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>, typename CapacityPolicy = ModuloCapacity>
+class MappedHashMap
+{
+  private:
+    using Map = HashMap<Key, Value, Hash, KeyEqual, CapacityPolicy>;
+    using Slot = typename Map::Slot;
+    // The mapping starts on a page boundary, so slots at SLOTS_OFFSET are aligned
+    static_assert(HashMapSnapshotHeader::SLOTS_OFFSET % alignof(Slot) == 0,
+                  "The slots of a snapshot must be aligned");
+
+    KeyEqual key_equal_;
+    Hash hasher_;
+    CapacityPolicy capacity_policy;
+    void *mapping;
+    size_t mapping_length, sz, number_of_slots_total;
+    const Slot *slots;
+
+    MappedHashMap()
+        : mapping(MAP_FAILED), mapping_length(0), sz(0), number_of_slots_total(0), slots(nullptr)
+    {
+    }
+
+    auto unmap() -> void
+    {
+        if (mapping != MAP_FAILED)
+            munmap(mapping, mapping_length);
+        mapping = MAP_FAILED;
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    // Maps the file at path, which was written by HashMap::save
+    static auto open_mapped(const std::string &path) -> MappedHashMap
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(), "Could not open " + path);
+        struct stat st;
+        if (fstat(fd, &st) == -1)
+        {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "Could not stat " + path);
+        }
+
+        MappedHashMap m;
+        m.mapping_length = static_cast<size_t>(st.st_size);
+        if (m.mapping_length < sizeof(HashMapSnapshotHeader))
+        {
+            close(fd);
+            throw std::runtime_error(path + " is not a HashMap snapshot");
+        }
+        m.mapping = mmap(nullptr, m.mapping_length, PROT_READ, MAP_SHARED, fd, 0);
+        int error = errno;
+        // The mapping stays valid after the file is closed
+        close(fd);
+        if (m.mapping == MAP_FAILED)
+            throw std::system_error(error, std::generic_category(), "Could not map " + path);
+
+        const auto *header = static_cast<const HashMapSnapshotHeader *>(m.mapping);
+        if (header->magic != HashMapSnapshotHeader::MAGIC)
+            throw std::runtime_error(path + " is not a HashMap snapshot");
+        if (header->version != HashMapSnapshotHeader::VERSION)
+            throw std::runtime_error(path + " has an unsupported snapshot version");
+        if (header->slot_size != sizeof(Slot) || header->key_size != sizeof(Key) ||
+            header->value_size != sizeof(Value))
+            throw std::runtime_error(path + " was saved with different key or value types");
+        if (header->capacity_policy != capacity_policy_tag<CapacityPolicy>::value)
+            throw std::runtime_error(path + " was saved with a different capacity policy");
+        if (header->hash_fingerprint != hash_fingerprint<Key>(m.hasher_))
+            throw std::runtime_error(path + " was saved with a different hash function");
+        // The slots are read in place, so they must start where save put them, which is aligned
+        // for Slot
+        if (header->slots_offset != HashMapSnapshotHeader::SLOTS_OFFSET)
+            throw std::runtime_error(path + " has an invalid slots offset");
+        // Divides instead of multiplying the capacity, which a corrupt file could make overflow
+        if (header->slots_offset > m.mapping_length ||
+            header->capacity > (m.mapping_length - header->slots_offset) / sizeof(Slot))
+            throw std::runtime_error(path + " is truncated");
+        // Lookups reduce hashes by the capacity, so it must be one the capacity policy could
+        // have chosen (for example a power of two), and non zero if the table holds elements
+        if (header->size > header->capacity || (header->capacity == 0 && header->size != 0) ||
+            CapacityPolicy::round_up(static_cast<size_t>(header->capacity)) != header->capacity)
+            throw std::runtime_error(path + " has an invalid size or capacity");
+
+        m.sz = static_cast<size_t>(header->size);
+        m.number_of_slots_total = static_cast<size_t>(header->capacity);
+        m.slots = reinterpret_cast<const Slot *>(static_cast<const char *>(m.mapping) +
+                                                 header->slots_offset);
+        if (m.number_of_slots_total)
+            m.capacity_policy.reset(m.number_of_slots_total);
+        return m;
+    }
+
+    MappedHashMap(const MappedHashMap &) = delete;
+
+    MappedHashMap &operator=(const MappedHashMap &) = delete;
+
+    MappedHashMap(MappedHashMap &&other) noexcept : MappedHashMap() { swap(*this, other); }
+
+    MappedHashMap &operator=(MappedHashMap &&other) noexcept
+    {
+        MappedHashMap moved(std::move(other));
+        swap(*this, moved);
+        return *this;
+    }
+
+    friend void swap(MappedHashMap &first, MappedHashMap &second) noexcept
+    {
+        using std::swap;
+        swap(first.key_equal_, second.key_equal_);
+        swap(first.hasher_, second.hasher_);
+        swap(first.capacity_policy, second.capacity_policy);
+        swap(first.mapping, second.mapping);
+        swap(first.mapping_length, second.mapping_length);
+        swap(first.sz, second.sz);
+        swap(first.number_of_slots_total, second.number_of_slots_total);
+        swap(first.slots, second.slots);
+    }
+
+    ~MappedHashMap() { unmap(); }
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        if (sz == 0)
+            return std::nullopt;
+        size_t probes = 0;
+        auto index = Map::probe(slots, number_of_slots_total, key,
+                                capacity_policy.index(hasher_(key)), key_equal_, probes);
+        if (index == number_of_slots_total)
+            return std::nullopt;
+        return slots[index].v;
+    }
+
+    auto contains(const Key &key) const -> bool { return find(key).has_value(); }
+
+    auto size() const -> size_type { return sz; }
+
+    auto empty() const -> bool { return sz == 0; }
+
+    auto capacity() const -> size_type { return number_of_slots_total; }
+
+    auto load_factor() const -> float
+    {
+        if (number_of_slots_total)
+            return static_cast<float>(sz) / static_cast<float>(number_of_slots_total);
+        return 0;
+    }
+};
+
+#endif // A_MAPPED_HASHMAP_H
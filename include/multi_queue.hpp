@@ -0,0 +1,157 @@
+#pragma once
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// A relaxed concurrent priority queue (a MultiQueue), for many threads sharing one scheduler
+//
+// The elements are spread over c * p PriorityQueue heaps, where p is the number of threads and c
+// a small constant, and each heap has its own lock
+//     * push(value) locks a random heap with try_lock, picking another heap if the lock is taken,
+//       and pushes into it
+//     * try_pop(out) picks two random heaps, and pops the larger of their two tops. After a few
+//       misses it scans every heap, skipping the busy ones. Locks are only ever taken with
+//       try_lock, so no thread waits for another while holding a lock
+// Threads rarely meet on the same lock, so throughput grows with the number of threads, but the
+// order is relaxed: the popped element is not always the largest one in the queue. Its rank (the
+// number of larger elements in the queue) is on average O(c * p), and O(c * p * log(c * p)) with
+// high probability, as shown for the two-choice process by Alistarh et al. ("The Power of Choice
+// in Priority Scheduling", PODC 2017). A single thread which pushes and pops sees the same bounds
+//
+// As with PriorityQueue, the top of each heap is its largest element under Compare
+template <typename T, typename Compare = std::less<T>, size_t Arity = 2> class MultiQueue
+{
+  private:
+    // Each heap is aligned to a cache line so that the locks of different heaps do not share one
+    struct alignas(64) Heap
+    {
+        std::mutex mutex;
+        PriorityQueue<T, std::vector<T, CacheAlignedAllocator<T>>, Compare, Arity> queue;
+    };
+
+    size_t number_of_heaps;
+    std::unique_ptr<Heap[]> heaps;
+    std::atomic<size_t> sz;
+    Compare comp;
+
+    // A per thread xorshift generator, seeded from the thread id
+    static uint64_t random()
+    {
+        thread_local uint64_t state =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ULL | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    size_t random_heap() { return static_cast<size_t>(random() % number_of_heaps); }
+
+    // Pops the top of heap into out, the heap must be locked and not empty
+    void pop_locked(Heap &heap, T &out)
+    {
+        heap.queue.pop(out);
+        sz.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef Compare value_compare;
+    static constexpr size_t DEFAULT_HEAPS_PER_THREAD = 2;
+    // Number of rounds of random choices try_pop makes before it scans every heap
+    static constexpr size_t MAX_POP_ATTEMPTS = 16;
+
+    // Uses heaps_per_thread heaps for each of the threads, at least two heaps in total
+    explicit MultiQueue(size_t threads = std::thread::hardware_concurrency(),
+                        size_t heaps_per_thread = DEFAULT_HEAPS_PER_THREAD,
+                        const Compare &compare = Compare())
+        : number_of_heaps(std::max<size_t>(2, threads * heaps_per_thread)), sz(0), comp(compare)
+    {
+        if (heaps_per_thread == 0)
+            throw std::logic_error("Number of heaps per thread should be greater than 0");
+        heaps = std::make_unique<Heap[]>(number_of_heaps);
+        // Every heap orders its elements with the same comparator that try_pop uses
+        for (size_t i = 0; i < number_of_heaps; ++i)
+            heaps[i].queue = decltype(heaps[i].queue)(comp);
+    }
+
+    void push(const value_type &value) { push(value_type(value)); }
+
+    void push(value_type &&value)
+    {
+        while (true)
+        {
+            Heap &heap = heaps[random_heap()];
+            std::unique_lock<std::mutex> lock(heap.mutex, std::try_to_lock);
+            if (lock.owns_lock())
+            {
+                heap.queue.push(std::move(value));
+                // Counted only once the push succeeded, and before the unlock, so that a pop of
+                // this element never sees a size of 0
+                sz.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    // Pops an element close to the top into out. Returns false if the queue is empty
+    bool try_pop(value_type &out)
+    {
+        for (size_t attempt = 0; attempt < MAX_POP_ATTEMPTS; ++attempt)
+        {
+            if (sz.load(std::memory_order_relaxed) == 0)
+                return false;
+            size_t i = random_heap(), j = random_heap();
+            if (i == j || !heaps[i].mutex.try_lock())
+                continue;
+            std::unique_lock<std::mutex> first(heaps[i].mutex, std::adopt_lock);
+            // If the second heap is busy, fall back to the first one
+            std::unique_lock<std::mutex> second(heaps[j].mutex, std::try_to_lock);
+            Heap *best = heaps[i].queue.empty() ? nullptr : &heaps[i];
+            if (second.owns_lock() && !heaps[j].queue.empty() &&
+                (!best || comp(best->queue.top(), heaps[j].queue.top())))
+                best = &heaps[j];
+            if (best)
+            {
+                pop_locked(*best, out);
+                return true;
+            }
+        }
+        // The random choices kept missing, most heaps are empty or busy. Look at every heap, busy
+        // heaps are skipped and the scan is repeated until it sees every heap empty
+        while (sz.load(std::memory_order_relaxed) > 0)
+        {
+            bool skipped = false;
+            for (size_t i = 0; i < number_of_heaps; ++i)
+            {
+                std::unique_lock<std::mutex> lock(heaps[i].mutex, std::try_to_lock);
+                if (!lock.owns_lock())
+                    skipped = true;
+                else if (!heaps[i].queue.empty())
+                {
+                    pop_locked(heaps[i], out);
+                    return true;
+                }
+            }
+            if (!skipped)
+                return false;
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    // The number of elements, which may be out of date when other threads modify the queue
+    size_type size() const { return sz.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+    size_type heap_count() const { return number_of_heaps; }
+};
@@ -0,0 +1,281 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+// Allocators for node based containers such as SinglyLinkedList and BSTSet, which otherwise call
+// new and delete once per element, and scatter their nodes over the heap
+//
+// Both allocators keep their memory in an object shared by all copies of the allocator, including
+// the copies rebound to the node type by the container, so a node can be freed through any copy.
+// A default constructed allocator makes its own pool or arena, pass the same allocator to several
+// containers to share one
+
+// A pool of fixed size nodes, taken from slabs of nodes_per_slab nodes
+class NodePool
+{
+  private:
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    size_t nodes_per_slab;
+    // The size of the nodes, set by the first allocation of a single object. Allocations of other
+    // sizes are not served by the pool
+    size_t node_size;
+    size_t stride;
+    FreeNode *free_list;
+    std::vector<void *> slabs;
+
+    void add_slab()
+    {
+        char *slab = static_cast<char *>(::operator new(stride * nodes_per_slab));
+        slabs.push_back(slab);
+        // Linked in reverse, so that the nodes are handed out in address order
+        for (size_t i = nodes_per_slab; i-- > 0;)
+            free_list = new (slab + i * stride) FreeNode{free_list};
+    }
+
+  public:
+    static constexpr size_t DEFAULT_NODES_PER_SLAB = 256;
+
+    explicit NodePool(size_t slab_nodes = DEFAULT_NODES_PER_SLAB)
+        : nodes_per_slab(std::max<size_t>(1, slab_nodes)), node_size(0), stride(0),
+          free_list(nullptr)
+    {
+    }
+
+    NodePool(const NodePool &) = delete;
+
+    NodePool &operator=(const NodePool &) = delete;
+
+    ~NodePool()
+    {
+        for (void *slab : slabs)
+            ::operator delete(slab);
+    }
+
+    // Returns true if nodes of this size come from the pool. The slabs are aligned for any
+    // fundamental type, and the stride is a multiple of both the size and the pointer alignment
+    bool serves(size_t size)
+    {
+        if (node_size == 0)
+        {
+            node_size = size;
+            stride = std::max(size, sizeof(FreeNode));
+            stride = (stride + alignof(FreeNode) - 1) / alignof(FreeNode) * alignof(FreeNode);
+        }
+        return size == node_size;
+    }
+
+    void *allocate()
+    {
+        if (!free_list)
+            add_slab();
+        FreeNode *node = free_list;
+        free_list = node->next;
+        return node;
+    }
+
+    void deallocate(void *p) { free_list = new (p) FreeNode{free_list}; }
+
+    size_t slab_count() const { return slabs.size(); }
+};
+
+// Allocates single objects from a NodePool, and arrays with operator new
+template <typename T> class PoolAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    template <typename U> friend class PoolAllocator;
+
+  private:
+    std::shared_ptr<NodePool> pool;
+
+  public:
+    typedef T value_type;
+
+    explicit PoolAllocator(size_t nodes_per_slab = NodePool::DEFAULT_NODES_PER_SLAB)
+        : pool(std::make_shared<NodePool>(nodes_per_slab))
+    {
+    }
+
+    template <typename U> PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *allocate(size_t n)
+    {
+        if (n == 1 && pool->serves(sizeof(T)))
+            return static_cast<T *>(pool->allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n == 1 && pool->serves(sizeof(T)))
+            pool->deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    const NodePool &resource() const { return *pool; }
+
+    template <typename U> bool operator==(const PoolAllocator<U> &other) const
+    {
+        return pool == other.pool;
+    }
+
+    template <typename U> bool operator!=(const PoolAllocator<U> &other) const
+    {
+        return pool != other.pool;
+    }
+};
+
+// A monotonic arena, which hands out memory from blocks by moving a cursor forward. Freeing single
+// objects does nothing, and clear() makes all the memory available again in O(1), keeping the
+// blocks for the next allocations
+class Arena
+{
+  private:
+    struct alignas(std::max_align_t) Block
+    {
+        Block *next;
+        size_t size;
+
+        char *data() { return reinterpret_cast<char *>(this + 1); }
+    };
+
+    size_t block_size;
+    Block *first;
+    Block *current;
+    char *cursor;
+    char *limit;
+
+    // Moves to the next block, or allocates one after the current block, with room for size bytes
+    // at the given alignment
+    void next_block(size_t size, size_t alignment)
+    {
+        size_t needed = size + alignment;
+        Block *next = current ? current->next : first;
+        if (!next || next->size < needed)
+        {
+            size_t bytes = std::max(block_size, needed);
+            Block *block = new (::operator new(sizeof(Block) + bytes)) Block{next, bytes};
+            (current ? current->next : first) = block;
+            next = block;
+        }
+        current = next;
+        cursor = current->data();
+        limit = cursor + current->size;
+    }
+
+  public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t bytes_per_block = DEFAULT_BLOCK_SIZE)
+        : block_size(std::max<size_t>(1, bytes_per_block)), first(nullptr), current(nullptr),
+          cursor(nullptr), limit(nullptr)
+    {
+    }
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        while (first)
+        {
+            Block *next = first->next;
+            ::operator delete(first);
+            first = next;
+        }
+    }
+
+    void *allocate(size_t size, size_t alignment)
+    {
+        auto address = reinterpret_cast<uintptr_t>(cursor);
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (!cursor || static_cast<size_t>(limit - cursor) < padding + size)
+        {
+            next_block(size, alignment);
+            address = reinterpret_cast<uintptr_t>(cursor);
+            padding = (alignment - address % alignment) % alignment;
+        }
+        void *p = cursor + padding;
+        cursor += padding + size;
+        return p;
+    }
+
+    // Makes all the memory available again, every object allocated from the arena must be dead
+    void clear()
+    {
+        current = nullptr;
+        cursor = limit = nullptr;
+    }
+
+    size_t block_count() const
+    {
+        size_t count = 0;
+        for (Block *block = first; block; block = block->next)
+            ++count;
+        return count;
+    }
+};
+
+// Allocates from an Arena, deallocate does nothing
+template <typename T> class ArenaAllocator
+{
+    template <typename U> friend class ArenaAllocator;
+
+  private:
+    std::shared_ptr<Arena> arena;
+
+  public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(size_t bytes_per_block = Arena::DEFAULT_BLOCK_SIZE)
+        : arena(std::make_shared<Arena>(bytes_per_block))
+    {
+    }
+
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T *, size_t) {}
+
+    // Clears the arena if no other allocator uses it. Containers call this from their clear(),
+    // after which they have no live node left
+    void clear_if_unshared()
+    {
+        if (arena.use_count() == 1)
+            arena->clear();
+    }
+
+    const Arena &resource() const { return *arena; }
+
+    template <typename U> bool operator==(const ArenaAllocator<U> &other) const
+    {
+        return arena == other.arena;
+    }
+
+    template <typename U> bool operator!=(const ArenaAllocator<U> &other) const
+    {
+        return arena != other.arena;
+    }
+};
+
+// True for allocators whose deallocate does nothing, so a container can drop its nodes without
+// visiting them, when they need no destructor
+template <typename Allocator> struct is_monotonic_allocator : std::false_type
+{
+};
+
+template <typename T> struct is_monotonic_allocator<ArenaAllocator<T>> : std::true_type
+{
+};
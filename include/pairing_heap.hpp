@@ -0,0 +1,315 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// A pairing heap, a priority queue where two heaps are merged in O(1) with meld, for example to
+// gather the queues of several shards into one. push and meld are O(1), pop and decrease_key are
+// amortized O(log n)
+//
+// As in IndexedPriorityQueue, the top is the smallest element under Compare, so that decrease_key
+// moves an element towards the top. push returns a handle to the element, which stays valid until
+// the element is popped, including after its heap is melded into another one
+//
+// The heap is a tree where every node is not greater than its children. Each node points to its
+// first child, its next sibling, and its previous sibling (or its parent, for a first child)
+//     * push and meld link two roots: the larger one becomes the first child of the smaller one
+//     * pop links the children of the root in pairs from left to right, then links the results
+//       from right to left into the new root
+//     * decrease_key cuts the node and its subtree from its parent, and links it with the root
+//
+// Nodes are taken from a pool of chunks owned by the heap. A freed node goes on a free list and is
+// reused by the next push, so push and pop rarely allocate. meld hands the chunks and free nodes
+// of the other heap over to this heap, by linking two lists, so it moves no element and allocates
+// nothing
+template <typename T, typename Compare = std::less<T>> class PairingHeap
+{
+  private:
+    struct Node
+    {
+        Node *child;
+        Node *next;
+        // The previous sibling, or the parent of a first child. In a free node, unused
+        Node *prev;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T &value() { return *std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    // A chunk is followed in memory by its nodes
+    struct alignas(alignof(Node)) Chunk
+    {
+        Chunk *next;
+        size_t capacity;
+
+        Node *nodes() { return reinterpret_cast<Node *>(this + 1); }
+    };
+
+    static constexpr size_t MIN_CHUNK_CAPACITY = 64;
+
+    Node *root;
+    size_t sz;
+    Compare comp;
+    // The chunks, and the free nodes linked through next. Both lists know their last element, so
+    // that meld can append the lists of another heap in O(1)
+    Chunk *first_chunk;
+    Chunk *last_chunk;
+    size_t capacity;
+    Node *free_head;
+    Node *free_tail;
+
+    void add_chunk()
+    {
+        size_t count = capacity < MIN_CHUNK_CAPACITY ? MIN_CHUNK_CAPACITY : capacity;
+        void *memory = ::operator new(sizeof(Chunk) + count * sizeof(Node),
+                                      std::align_val_t(alignof(Chunk)));
+        Chunk *chunk = new (memory) Chunk{nullptr, count};
+        if (last_chunk)
+            last_chunk->next = chunk;
+        else
+            first_chunk = chunk;
+        last_chunk = chunk;
+        capacity += count;
+        for (size_t i = 0; i < count; ++i)
+            release(new (chunk->nodes() + i) Node);
+    }
+
+    template <typename... Args> Node *make_node(Args &&...args)
+    {
+        if (!free_head)
+            add_chunk();
+        Node *node = free_head;
+        new (node->storage) T(std::forward<Args>(args)...);
+        free_head = node->next;
+        if (!free_head)
+            free_tail = nullptr;
+        node->child = node->next = node->prev = nullptr;
+        return node;
+    }
+
+    // Puts a node, whose value is already destroyed, on the free list
+    void release(Node *node)
+    {
+        node->next = free_head;
+        free_head = node;
+        if (!free_tail)
+            free_tail = node;
+    }
+
+    // Links two roots, either of which may be null, and returns the new root
+    Node *link(Node *a, Node *b)
+    {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+        if (comp(b->value(), a->value()))
+            std::swap(a, b);
+        b->prev = a;
+        b->next = a->child;
+        if (a->child)
+            a->child->prev = b;
+        a->child = b;
+        a->next = a->prev = nullptr;
+        return a;
+    }
+
+    // Two pass pairing of a list of siblings. The first pass links pairs from left to right and
+    // chains the results in reverse order through next, the second pass links them from right
+    // to left
+    Node *merge_pairs(Node *first)
+    {
+        Node *pairs = nullptr;
+        while (first)
+        {
+            Node *a = first;
+            Node *b = a->next;
+            first = b ? b->next : nullptr;
+            a->next = a->prev = nullptr;
+            if (b)
+                b->next = b->prev = nullptr;
+            Node *pair = link(a, b);
+            pair->next = pairs;
+            pairs = pair;
+        }
+        Node *result = nullptr;
+        while (pairs)
+        {
+            Node *next = pairs->next;
+            pairs->next = nullptr;
+            result = link(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+    // Detaches a node which is not the root, with its subtree
+    void cut(Node *node)
+    {
+        if (node->prev->child == node)
+            node->prev->child = node->next;
+        else
+            node->prev->next = node->next;
+        if (node->next)
+            node->next->prev = node->prev;
+        node->next = node->prev = nullptr;
+    }
+
+    void free_chunks()
+    {
+        while (first_chunk)
+        {
+            Chunk *next = first_chunk->next;
+            ::operator delete(first_chunk, std::align_val_t(alignof(Chunk)));
+            first_chunk = next;
+        }
+        last_chunk = nullptr;
+        free_head = free_tail = nullptr;
+        capacity = 0;
+    }
+
+  public:
+    typedef T value_type;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef Compare value_compare;
+
+    // Refers to an element of the heap, from push until the element is popped
+    class handle
+    {
+        friend class PairingHeap;
+        Node *node;
+
+        explicit handle(Node *n) : node(n) {}
+
+      public:
+        handle() : node(nullptr) {}
+
+        bool operator==(const handle &other) const { return node == other.node; }
+
+        bool operator!=(const handle &other) const { return node != other.node; }
+    };
+
+    explicit PairingHeap(const Compare &compare = Compare())
+        : root(nullptr), sz(0), comp(compare), first_chunk(nullptr), last_chunk(nullptr),
+          capacity(0), free_head(nullptr), free_tail(nullptr)
+    {
+    }
+
+    PairingHeap(const PairingHeap &) = delete;
+
+    PairingHeap &operator=(const PairingHeap &) = delete;
+
+    PairingHeap(PairingHeap &&other) : PairingHeap(other.comp) { meld(other); }
+
+    ~PairingHeap()
+    {
+        clear();
+        free_chunks();
+    }
+
+    const_reference top() const { return root->value(); }
+
+    const_reference value(handle h) const { return h.node->value(); }
+
+    size_type size() const { return sz; }
+
+    bool empty() const { return sz == 0; }
+
+    value_compare value_comp() const { return comp; }
+
+    handle push(const value_type &value) { return emplace(value); }
+
+    handle push(value_type &&value) { return emplace(std::move(value)); }
+
+    template <typename... Args> handle emplace(Args &&...args)
+    {
+        Node *node = make_node(std::forward<Args>(args)...);
+        root = link(root, node);
+        ++sz;
+        return handle(node);
+    }
+
+    void pop()
+    {
+        Node *old = root;
+        root = merge_pairs(old->child);
+        old->value().~T();
+        release(old);
+        --sz;
+    }
+
+    // Sets a value which is not greater than the current one, moving the element towards the top
+    void decrease_key(handle h, value_type value)
+    {
+        Node *node = h.node;
+        if (comp(node->value(), value))
+            throw std::logic_error("decrease_key was given a greater value");
+        node->value() = std::move(value);
+        if (node == root)
+            return;
+        cut(node);
+        root = link(root, node);
+    }
+
+    // Moves every element of other into this heap in O(1), other is left empty. The handles to the
+    // elements of other stay valid, and now refer to elements of this heap
+    void meld(PairingHeap &other)
+    {
+        if (&other == this)
+            return;
+        root = link(root, other.root);
+        sz += other.sz;
+        if (other.first_chunk)
+        {
+            if (last_chunk)
+                last_chunk->next = other.first_chunk;
+            else
+                first_chunk = other.first_chunk;
+            last_chunk = other.last_chunk;
+            capacity += other.capacity;
+        }
+        if (other.free_head)
+        {
+            if (free_tail)
+                free_tail->next = other.free_head;
+            else
+                free_head = other.free_head;
+            free_tail = other.free_tail;
+        }
+        other.root = nullptr;
+        other.sz = 0;
+        other.first_chunk = other.last_chunk = nullptr;
+        other.capacity = 0;
+        other.free_head = other.free_tail = nullptr;
+    }
+
+    // Removes every element in O(n). The nodes are kept for the next pushes
+    void clear()
+    {
+        // Walks the tree as a list, where the children of a node are spliced in place of the node
+        Node *list = root;
+        while (list)
+        {
+            Node *node = list;
+            list = node->next;
+            if (Node *child = node->child)
+            {
+                Node *tail = child;
+                while (tail->next)
+                    tail = tail->next;
+                tail->next = list;
+                list = child;
+            }
+            node->value().~T();
+            release(node);
+        }
+        root = nullptr;
+        sz = 0;
+    }
+
+    // The number of nodes in the pool, used or free
+    size_type pool_capacity() const { return capacity; }
+};
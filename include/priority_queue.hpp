@@ -3,72 +3,293 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <new>
+#include <utility>
+#include <type_traits>
 #include <vector>
 
-template <typename T, typename Container = std::vector<T>,
-          typename Compare = std::less<typename Container::value_type>>
+// Allocates arrays where the element at index 1 starts a cache line. This is the allocator of the
+// default container of PriorityQueue, where the children of node i start at index Arity*i + 1, so
+// that every group of siblings starts on a cache line. The array starts SHIFT bytes into a block
+// aligned to a cache line
+template <typename T> struct CacheAlignedAllocator
+{
+    typedef T value_type;
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t BLOCK_ALIGNMENT = alignof(T) > ALIGNMENT ? alignof(T) : ALIGNMENT;
+    // A multiple of alignof(T), as both ALIGNMENT and sizeof(T) are
+    static constexpr size_t SHIFT = (ALIGNMENT - sizeof(T) % ALIGNMENT) % ALIGNMENT;
+
+    CacheAlignedAllocator() {}
+
+    template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        void *block = ::operator new(n * sizeof(T) + SHIFT, std::align_val_t(BLOCK_ALIGNMENT));
+        return reinterpret_cast<T *>(static_cast<char *>(block) + SHIFT);
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        ::operator delete(reinterpret_cast<char *>(p) - SHIFT, std::align_val_t(BLOCK_ALIGNMENT));
+    }
+
+    template <typename U> bool operator==(const CacheAlignedAllocator<U> &) const { return true; }
+
+    template <typename U> bool operator!=(const CacheAlignedAllocator<U> &) const { return false; }
+};
+
+// True for containers which keep their elements in a single array
+template <typename Container> struct is_contiguous_container : std::false_type
+{
+};
+
+template <typename T, typename Allocator>
+struct is_contiguous_container<std::vector<T, Allocator>> : std::true_type
+{
+};
+
+namespace detail
+{
+// Moves a value into slot i of a heap
+struct MoveInto
+{
+    template <typename It, typename V> void operator()(It heap, size_t i, V &&value) const
+    {
+        heap[i] = std::move(value);
+    }
+};
+
+// The d-ary max heap shared by PriorityQueue and IndexedPriorityQueue, on the first n elements of
+// a random access sequence. For a node i, its children are the nodes Arity*i + 1 to Arity*i + Arity
+// Wider nodes make the heap shallower, so a sift down visits fewer levels. It compares more
+// children on each level, but they are next to each other in memory
+//
+// Elements are moved along a "hole" when sifting: the element being placed is kept aside, the
+// elements it passes are moved into the hole one at a time, and it is moved into the final
+// position once. This is one move per level instead of the three of a swap
+//
+// Every element is moved into the heap through place(heap, i, value), so that a queue which keeps
+// the position of its elements, such as IndexedPriorityQueue, can update it
+template <size_t Arity> struct DaryHeap
+{
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+
+    static size_t parent(size_t i) { return (i - 1) / Arity; }
+
+    // Returns the child of i which should be closest to the top, i must have at least one child.
+    // With two children, the choice is a branch, as in the binary heap this replaced. It lets the
+    // CPU start loading the next level before the comparison is resolved.
+    // For a full wide node in an array (heap is a pointer), the loop has a fixed trip count over
+    // consecutive elements, and the selection compiles to conditional moves instead of branches
+    template <typename It, typename Compare>
+    static size_t best_child(It heap, size_t n, size_t i, Compare &comp)
+    {
+        size_t first = Arity * i + 1;
+        if constexpr (Arity == 2)
+        {
+            if (first + 1 < n && comp(heap[first], heap[first + 1]))
+                return first + 1;
+            return first;
+        }
+        else if constexpr (std::is_pointer<It>::value)
+        {
+            if (first + Arity <= n)
+            {
+                It children = heap + first;
+                size_t offset = 0;
+                for (size_t c = 1; c < Arity; ++c)
+                    offset = comp(children[offset], children[c]) ? c : offset;
+                return first + offset;
+            }
+        }
+        size_t best = first;
+        for (size_t c = first + 1; c < std::min(first + Arity, n); ++c)
+            best = comp(heap[best], heap[c]) ? c : best;
+        return best;
+    }
+
+    // Moves node i up until its parent is not smaller
+    template <typename It, typename Compare, typename Place = MoveInto>
+    static void sift_up(It heap, size_t i, Compare &comp, Place place = Place())
+    {
+        typename std::iterator_traits<It>::value_type value = std::move(heap[i]);
+        while (i > 0 && comp(heap[parent(i)], value))
+        {
+            place(heap, i, std::move(heap[parent(i)]));
+            i = parent(i);
+        }
+        place(heap, i, std::move(value));
+    }
+
+    // Places value in the hole at node i, or below it, until no child is larger
+    template <typename It, typename V, typename Compare, typename Place = MoveInto>
+    static void sift_down(It heap, size_t n, size_t i, V value, Compare &comp,
+                          Place place = Place())
+    {
+        while (Arity * i + 1 < n)
+        {
+            size_t child = best_child(heap, n, i, comp);
+            if (!comp(value, heap[child]))
+                break;
+            place(heap, i, std::move(heap[child]));
+            i = child;
+        }
+        place(heap, i, std::move(value));
+    }
+
+    // Places value in the hole at node i, when it is expected to end up near the bottom, such as
+    // the last element replacing a popped top. Instead of comparing it on every level, the hole is
+    // moved down to a leaf along the larger children, and the value is sifted up from there
+    // (bottom-up heapsort's trick), which saves a comparison and a hard to predict branch per level
+    template <typename It, typename V, typename Compare, typename Place = MoveInto>
+    static void sift_down_bottom_up(It heap, size_t n, size_t i, V value, Compare &comp,
+                                    Place place = Place())
+    {
+        while (Arity * i + 1 < n)
+        {
+            size_t child = best_child(heap, n, i, comp);
+            place(heap, i, std::move(heap[child]));
+            i = child;
+        }
+        place(heap, i, std::move(value));
+        sift_up(heap, i, comp, place);
+    }
+
+    // Floyd's heap construction, sifts down every node which has children, starting from the last
+    // one. This is O(n), as most nodes are near the bottom and move only a few levels
+    template <typename It, typename Compare, typename Place = MoveInto>
+    static void heapify(It heap, size_t n, Compare &comp, Place place = Place())
+    {
+        if (n < 2)
+            return;
+        for (size_t i = parent(n - 1) + 1; i-- > 0;)
+            sift_down(heap, n, i, std::move(heap[i]), comp, place);
+    }
+};
+} // namespace detail
+
+template <typename T, typename Container = std::vector<T, CacheAlignedAllocator<T>>,
+          typename Compare = std::less<typename Container::value_type>, size_t Arity = 2>
 class PriorityQueue
 {
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+
   private:
-    // This implementation uses a max heap
-    // For a node i, it's left child is at index 2*i + 1 and right child at 2*i + 2
+    // This implementation uses a max heap, where every node has Arity children, see DaryHeap
+    //
+    // The default container is a std::vector with CacheAlignedAllocator, not std::allocator, so
+    // code which names the container type of a PriorityQueue<T> has to use container_type
+    //
+    // Node i is stored at container[i]. With the default container, whose allocator aligns the
+    // element at index 1 to a cache line, and Arity * sizeof(T) == 64, all children of a node are
+    // in one cache line
+    typedef detail::DaryHeap<Arity> Heap;
 
     Container container;
+    Compare comp;
 
-    size_t parent(size_t i)
+    // The start of the heap, a pointer for containers which keep their elements in one array
+    auto heap()
     {
-        if (i % 2 == 0)
-            return i / 2 - 1;
+        if constexpr (is_contiguous_container<Container>::value)
+            return container.data();
         else
-            return i / 2;
+            return container.begin();
     }
 
-  public:
-    PriorityQueue() {}
+    void sift_up(size_t i) { Heap::sift_up(heap(), i, comp); }
+
+    void heapify() { Heap::heapify(heap(), size(), comp); }
 
+  public:
     typedef T value_type;
     typedef T &reference;
     typedef const T &const_reference;
     typedef size_t size_type;
     typedef Container container_type;
     typedef Compare value_compare;
+    static constexpr size_t arity = Arity;
+
+    PriorityQueue() : PriorityQueue(Compare()) {}
+
+    explicit PriorityQueue(const Compare &compare) : comp(compare) {}
+
+    // Builds a heap of the elements of [first, last) in O(n)
+    template <typename InputIt>
+    PriorityQueue(InputIt first, InputIt last, const Compare &compare = Compare())
+        : container(first, last), comp(compare)
+    {
+        heapify();
+    }
+
+    value_compare value_comp() const { return comp; }
 
     const_reference top() const { return container.front(); }
 
     size_type size() const { return container.size(); }
 
-    bool empty() const { return container.empty(); }
+    bool empty() const { return size() == 0; }
 
     void push(const value_type &value)
     {
         container.push_back(value);
-        size_t i = container.size() - 1;
-        while (i > 0 && Compare{}(container[parent(i)], container[i]))
-        {
-            std::swap(container[i], container[parent(i)]);
-            i = parent(i);
-        }
+        sift_up(size() - 1);
+    }
+
+    void push(value_type &&value)
+    {
+        container.push_back(std::move(value));
+        sift_up(size() - 1);
     }
 
+    template <typename... Args> void emplace(Args &&...args)
+    {
+        container.emplace_back(std::forward<Args>(args)...);
+        sift_up(size() - 1);
+    }
+
+    // Pushes the elements of [first, last). A batch which is large compared to the heap is
+    // appended and the whole heap is rebuilt in O(n + k), otherwise the elements are pushed one
+    // by one in O(k log n)
+    template <typename InputIt> void push_range(InputIt first, InputIt last)
+    {
+        size_t old_size = size();
+        container.insert(container.end(), first, last);
+        size_t k = size() - old_size;
+        size_t levels = 0;
+        for (size_t n = size(); n > 1; n /= Arity)
+            ++levels;
+        if (k * levels > 2 * size())
+            heapify();
+        else
+            for (size_t i = old_size; i < size(); ++i)
+                sift_up(i);
+    }
+
+    // Replaces the top with value, with a single sift down instead of a pop and a push. The queue
+    // must not be empty
+    void replace_top(value_type value)
+    {
+        Heap::sift_down(heap(), size(), 0, std::move(value), comp);
+    }
+
+    // The last element replaces the top. It is usually one of the smallest, so it is placed with a
+    // bottom-up sift down
     void pop()
     {
-        std::swap(container[0], container.back());
+        T value = std::move(container.back());
         container.pop_back();
-        size_t i = 0;
-        while ((2 * i + 1) < size())
-        {
-            reference left = container[2 * i + 1];
-            reference right = ((2 * i + 2) < size()) ? container[2 * i + 2] : left;
-            reference ref = !Compare{}(left, right) ? left : right;
-            if (!Compare{}(container[i], ref))
-                break;
-
-            std::swap(container[i], ref);
+        if (!empty())
+            Heap::sift_down_bottom_up(heap(), size(), 0, std::move(value), comp);
+    }
 
-            if (std::addressof(ref) == std::addressof(left))
-                i = 2 * i + 1;
-            else
-                i = 2 * i + 2;
-        }
+    // Moves the top into out and pops it, so that move only elements can be taken out of the
+    // queue. The queue must not be empty
+    void pop(reference out)
+    {
+        out = std::move(container.front());
+        pop();
     }
-};
\ No newline at end of file
+};
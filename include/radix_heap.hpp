@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+// A monotone priority queue of integers, for event simulations, timers or Dijkstra's shortest
+// paths with integer weights, where no element smaller than the last one taken from the top is
+// ever pushed
+//
+// The top is the smallest element, as in a PriorityQueue<T, Container, std::greater<T>>, which has
+// the same push, top, pop, size and empty. Pushing an element smaller than the last element
+// returned by top() or removed by pop() throws std::logic_error
+//
+// Elements are kept in digits + 1 buckets (33 for 32 bit integers, 65 for 64 bit ones). Bucket 0
+// holds the elements equal to last, the last minimum, and bucket b > 0 those whose highest bit
+// which differs from last is bit b - 1. So push is O(1), and when bucket 0 runs empty, the first
+// non-empty bucket is emptied into the buckets below it, relative to its own minimum. An element
+// only ever moves to a lower bucket, so pop is amortized O(log C), where C is the largest
+// difference between an element and the minimum, without comparing elements to each other
+template <typename T> class RadixHeap
+{
+    static_assert(std::is_integral<T>::value, "RadixHeap keys must be integers");
+
+  private:
+    typedef std::make_unsigned_t<T> Bits;
+    static constexpr size_t DIGITS = std::numeric_limits<Bits>::digits;
+    static constexpr size_t BUCKETS = DIGITS + 1;
+
+    // top() moves elements between buckets, but not in or out of the heap
+    mutable std::vector<T> buckets[BUCKETS];
+    mutable Bits last;
+    size_t sz;
+
+    // Maps the integer to an unsigned one with the same order, by flipping the sign bit
+    static Bits bits_of(T value)
+    {
+        Bits bits = static_cast<Bits>(value);
+        if constexpr (std::is_signed<T>::value)
+            bits = static_cast<Bits>(bits ^ (Bits(1) << (DIGITS - 1)));
+        return bits;
+    }
+
+    size_t bucket_of(Bits bits) const
+    {
+        if (bits == last)
+            return 0;
+        return 64 - static_cast<size_t>(__builtin_clzll(static_cast<uint64_t>(bits ^ last)));
+    }
+
+    // Makes bucket 0 hold the smallest elements, the heap must not be empty
+    void pull() const
+    {
+        if (!buckets[0].empty())
+            return;
+        size_t b = 1;
+        while (buckets[b].empty())
+            ++b;
+        Bits smallest = bits_of(buckets[b].front());
+        for (T value : buckets[b])
+            smallest = bits_of(value) < smallest ? bits_of(value) : smallest;
+        last = smallest;
+        // Every element of bucket b now differs from last in a lower bit than b - 1
+        for (T value : buckets[b])
+            buckets[bucket_of(bits_of(value))].push_back(value);
+        buckets[b].clear();
+    }
+
+  public:
+    typedef T value_type;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+
+    RadixHeap() : last(0), sz(0) {}
+
+    // The smallest element
+    const_reference top() const
+    {
+        pull();
+        return buckets[0].back();
+    }
+
+    size_type size() const { return sz; }
+
+    bool empty() const { return sz == 0; }
+
+    void push(value_type value)
+    {
+        Bits bits = bits_of(value);
+        if (bits < last)
+            throw std::logic_error("RadixHeap was given an element smaller than the last top");
+        buckets[bucket_of(bits)].push_back(value);
+        ++sz;
+    }
+
+    void pop()
+    {
+        pull();
+        buckets[0].pop_back();
+        --sz;
+    }
+
+    // Removes every element, after which any element can be pushed again
+    void clear()
+    {
+        for (auto &bucket : buckets)
+            bucket.clear();
+        last = 0;
+        sz = 0;
+    }
+};
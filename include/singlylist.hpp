@@ -1,8 +1,14 @@
 #pragma once
+#include "node_allocator.hpp"
 #include <iostream>
+#include <memory>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
-template <typename T> class SinglyLinkedList
+// Nodes are allocated with Allocator, rebound to the node type. With a PoolAllocator or an
+// ArenaAllocator, the nodes are next to each other in memory instead of spread over the heap
+template <typename T, typename Allocator = std::allocator<T>> class SinglyLinkedList
 {
   private:
     class Node
@@ -10,18 +16,46 @@ template <typename T> class SinglyLinkedList
         T value;
         Node *next;
         friend SinglyLinkedList;
+
+        Node(const T &t) : value(t), next(nullptr) {}
     };
 
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeTraits;
+
     Node *head;
     Node *tail;
     size_t sz;
+    NodeAllocator alloc;
 
+    Node *make_node(const T &t)
+    {
+        Node *node = NodeTraits::allocate(alloc, 1);
+        // Returns the node to the allocator if copying the value throws, as new Node would
+        try
+        {
+            new (node) Node(t);
+        }
+        catch (...)
+        {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void free_node(Node *node)
+    {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    }
 
   public:
     typedef size_t size_type;
     typedef T &reference;
     typedef const T &const_reference;
     typedef T value_type;
+    typedef Allocator allocator_type;
 
     class ConstIterator
     {
@@ -87,6 +121,13 @@ template <typename T> class SinglyLinkedList
 
     SinglyLinkedList() : head(nullptr), tail(nullptr), sz(0) {}
 
+    explicit SinglyLinkedList(const Allocator &allocator)
+        : head(nullptr), tail(nullptr), sz(0), alloc(allocator)
+    {
+    }
+
+    allocator_type get_allocator() const { return allocator_type(alloc); }
+
     Iterator begin() { return Iterator(head); }
 
     Iterator end() { return Iterator(nullptr); }
@@ -98,8 +139,7 @@ template <typename T> class SinglyLinkedList
     // Prepends the value to the front of the list
     void push_front(const T &t)
     {
-        Node *new_node = new Node;
-        new_node->value = t;
+        Node *new_node = make_node(t);
         // The list is currently empty
         if (head == nullptr)
         {
@@ -118,8 +158,7 @@ template <typename T> class SinglyLinkedList
     // Appends the value to the end of the list
     void push_back(const T &t)
     {
-        Node *new_node = new Node;
-        new_node->value = t;
+        Node *new_node = make_node(t);
         new_node->next = nullptr;
 
         // The list is currently empty
@@ -140,13 +179,20 @@ template <typename T> class SinglyLinkedList
 
     void clear()
     {
-
-        while (head)
+        // An arena frees nothing node by node, so nodes which need no destructor are all dropped
+        // at once
+        if constexpr (!is_monotonic_allocator<NodeAllocator>::value ||
+                      !std::is_trivially_destructible<Node>::value)
         {
-            Node *next_node = head->next;
-            delete head;
-            head = next_node;
+            while (head)
+            {
+                Node *next_node = head->next;
+                free_node(head);
+                head = next_node;
+            }
         }
+        if constexpr (is_monotonic_allocator<NodeAllocator>::value)
+            alloc.clear_if_unshared();
         sz = 0;
         head = nullptr;
         tail = nullptr;
@@ -158,6 +204,7 @@ template <typename T> class SinglyLinkedList
     // Copy constructor, move constructor, copy assignment, move assignment, and the destructor
 
     SinglyLinkedList(const SinglyLinkedList &other)
+        : SinglyLinkedList(NodeTraits::select_on_container_copy_construction(other.alloc))
     {
         for (const auto &v : other)
         {
@@ -177,9 +224,13 @@ template <typename T> class SinglyLinkedList
         swap(first.head, second.head);
         swap(first.tail, second.tail);
         swap(first.sz, second.sz);
+        swap(first.alloc, second.alloc);
     }
 
-    SinglyLinkedList(SinglyLinkedList &&other) noexcept { swap(*this, other); }
+    SinglyLinkedList(SinglyLinkedList &&other) noexcept : SinglyLinkedList(other.alloc)
+    {
+        swap(*this, other);
+    }
 
     // Solve problems from
     // http://cslibrary.stanford.edu/105/LinkedListProblems.pdf
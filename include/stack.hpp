@@ -1,5 +1,231 @@
 #pragma once
+#include <cstddef>
 #include <deque>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A container for Stack, for stacks which are shallow most of the time and grow and shrink often,
+// such as the stack of a depth first search
+//
+// The first InlineCapacity elements are stored inside the object, so a small stack never
+// allocates. Past them, the elements go into chunks of ChunkCapacity elements, which are linked in
+// a list. A chunk which becomes empty is kept in the list for the next pushes instead of being
+// freed, so once the stack has been as deep as it gets, push_back and pop_back never allocate.
+// shrink_to_fit frees the chunks which are not in use
+template <typename T, size_t InlineCapacity = 16, size_t ChunkCapacity = 256>
+class SmallChunkedBuffer
+{
+    static_assert(InlineCapacity > 0 && ChunkCapacity > 0, "Segments can not be empty");
+
+  private:
+    struct Chunk
+    {
+        Chunk *prev;
+        Chunk *next;
+        alignas(T) unsigned char storage[ChunkCapacity * sizeof(T)];
+
+        T *data() { return reinterpret_cast<T *>(storage); }
+    };
+
+    alignas(T) unsigned char inline_storage[InlineCapacity * sizeof(T)];
+    // The chunks, the ones after the current chunk are empty
+    Chunk *first_chunk;
+    // The chunk which holds the last element, or null while the elements fit inline
+    Chunk *current;
+    // The segment (the inline storage or the current chunk) which holds the last element, and the
+    // position after the last element. top is only equal to segment_begin for an empty buffer
+    T *segment_begin;
+    T *segment_end;
+    T *top;
+    size_t sz;
+    size_t chunks;
+
+    T *inline_data() { return reinterpret_cast<T *>(inline_storage); }
+
+    void enter(Chunk *chunk)
+    {
+        current = chunk;
+        segment_begin = chunk ? chunk->data() : inline_data();
+        segment_end = segment_begin + (chunk ? ChunkCapacity : InlineCapacity);
+    }
+
+    // Returns the chunk after the current one, allocating it only if no empty chunk is left
+    Chunk *next_chunk()
+    {
+        Chunk *next = current ? current->next : first_chunk;
+        if (!next)
+        {
+            next = new Chunk;
+            next->prev = current;
+            next->next = nullptr;
+            (current ? current->next : first_chunk) = next;
+            ++chunks;
+        }
+        return next;
+    }
+
+    // Takes the elements and the chunks of other, which is left empty without chunks. This buffer
+    // must be empty without chunks. The chunks are handed over, only the inline elements are moved
+    void steal(SmallChunkedBuffer &other)
+    {
+        size_t inline_size = other.sz < InlineCapacity ? other.sz : InlineCapacity;
+        T *from = other.inline_data();
+        for (size_t i = 0; i < inline_size; ++i)
+            push_back(std::move(from[i]));
+        for (size_t i = 0; i < inline_size; ++i)
+            from[i].~T();
+        first_chunk = other.first_chunk;
+        chunks = other.chunks;
+        sz = other.sz;
+        if (other.current)
+        {
+            enter(other.current);
+            top = other.top;
+        }
+        other.first_chunk = nullptr;
+        other.chunks = 0;
+        other.sz = 0;
+        other.enter(nullptr);
+        other.top = other.segment_begin;
+    }
+
+    template <typename Fn> void for_each(Fn fn) const
+    {
+        size_t left = sz;
+        const T *data = reinterpret_cast<const T *>(inline_storage);
+        for (size_t i = 0; i < InlineCapacity && left > 0; ++i, --left)
+            fn(data[i]);
+        for (Chunk *chunk = first_chunk; left > 0; chunk = chunk->next)
+            for (size_t i = 0; i < ChunkCapacity && left > 0; ++i, --left)
+                fn(chunk->data()[i]);
+    }
+
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    static constexpr size_t inline_capacity = InlineCapacity;
+    static constexpr size_t chunk_capacity = ChunkCapacity;
+
+    SmallChunkedBuffer() : first_chunk(nullptr), sz(0), chunks(0)
+    {
+        enter(nullptr);
+        top = segment_begin;
+    }
+
+    SmallChunkedBuffer(const SmallChunkedBuffer &other) : SmallChunkedBuffer()
+    {
+        other.for_each([this](const T &value) { push_back(value); });
+    }
+
+    SmallChunkedBuffer &operator=(const SmallChunkedBuffer &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            other.for_each([this](const T &value) { push_back(value); });
+        }
+        return *this;
+    }
+
+    SmallChunkedBuffer(SmallChunkedBuffer &&other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+        : SmallChunkedBuffer()
+    {
+        steal(other);
+    }
+
+    SmallChunkedBuffer &operator=(SmallChunkedBuffer &&other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            clear();
+            shrink_to_fit();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallChunkedBuffer()
+    {
+        clear();
+        while (first_chunk)
+        {
+            Chunk *next = first_chunk->next;
+            delete first_chunk;
+            first_chunk = next;
+        }
+    }
+
+    size_type size() const { return sz; }
+
+    bool empty() const { return sz == 0; }
+
+    reference back() { return top[-1]; }
+
+    const_reference back() const { return top[-1]; }
+
+    template <typename... Args> reference emplace_back(Args &&...args)
+    {
+        if (top == segment_end)
+        {
+            // The element is constructed before moving to the next chunk, so that the buffer is
+            // left as it was if the constructor throws
+            Chunk *next = next_chunk();
+            T *slot = new (next->data()) T(std::forward<Args>(args)...);
+            enter(next);
+            top = segment_begin + 1;
+            ++sz;
+            return *slot;
+        }
+        T *slot = new (top) T(std::forward<Args>(args)...);
+        ++top;
+        ++sz;
+        return *slot;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        (--top)->~T();
+        --sz;
+        // Steps back to the previous segment, which is full, so that back() is always top[-1]
+        if (top == segment_begin && current)
+        {
+            enter(current->prev);
+            top = segment_end;
+        }
+    }
+
+    void clear()
+    {
+        while (sz > 0)
+            pop_back();
+    }
+
+    // Frees the chunks which hold no element
+    void shrink_to_fit()
+    {
+        Chunk *spare = current ? current->next : first_chunk;
+        (current ? current->next : first_chunk) = nullptr;
+        while (spare)
+        {
+            Chunk *next = spare->next;
+            delete spare;
+            --chunks;
+            spare = next;
+        }
+    }
+
+    // The number of chunks, in use or kept for later
+    size_type chunk_count() const { return chunks; }
+};
 
 template <typename T, class Container = std::deque<T>> class Stack
 {
@@ -26,4 +252,4 @@ template <typename T, class Container = std::deque<T>> class Stack
     void push(T &&t) { c.push_back(std::move(t)); }
 
     void pop() { c.pop_back(); }
-};
\ No newline at end of file
+};
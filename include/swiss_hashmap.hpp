@@ -0,0 +1,323 @@
+#ifndef A_SWISS_HASHMAP_H
+#define A_SWISS_HASHMAP_H
+#include "hash.hpp"
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * SwissHashMap
+ * ============
+ * An open addressing hash table in the style of Swiss tables (abseil's flat_hash_map).
+ * Design choices
+ * 1) The metadata is kept apart from the key/value pairs, in an array of 1 byte control tags.
+ * A control byte is either EMPTY, DELETED, or the lower 7 bits of the hash of the key (h2) stored
+ * in the corresponding slot
+ * 2) The slots are split into groups of GROUP_WIDTH slots. A probe loads the control bytes of a
+ * whole group and compares all of them against h2 at once (SSE2 - 16 slots, AVX2 - 32 slots, or a
+ * plain loop when neither is available). Keys are compared only on a tag match, so a lookup
+ * usually touches one control line and one slot
+ * 3) The upper bits of the hash (h1) select the first group, and the groups are then visited
+ * using triangular (quadratic) probing, which visits every group as the number of groups is a
+ * power of two
+ * 4) Supports the same operations as HashMap, find, insert, erase, contains, size, clear
+ * 5) As with HashMap, Key and Value have to be DefaultConstructible
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class SwissHashMap
+{
+  private:
+    using ctrl_t = int8_t;
+
+    static constexpr ctrl_t EMPTY = -128; // 0b10000000
+    static constexpr ctrl_t DELETED = -2; // 0b11111110
+
+    struct Slot
+    {
+        Key k;
+        Value v;
+    };
+
+    // A set of matching positions within a group, one bit per slot
+    using Mask = uint32_t;
+
+    struct Group
+    {
+#if defined(__AVX2__)
+        static constexpr size_t WIDTH = 32;
+        __m256i ctrl;
+
+        explicit Group(const ctrl_t *pos)
+            : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos)))
+        {
+        }
+
+        Mask match(ctrl_t h2) const
+        {
+            return static_cast<Mask>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+        }
+
+        // EMPTY and DELETED are the only control bytes with the sign bit set
+        Mask match_empty_or_deleted() const
+        {
+            return static_cast<Mask>(_mm256_movemask_epi8(ctrl));
+        }
+#elif defined(__SSE2__)
+        static constexpr size_t WIDTH = 16;
+        __m128i ctrl;
+
+        explicit Group(const ctrl_t *pos)
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)))
+        {
+        }
+
+        Mask match(ctrl_t h2) const
+        {
+            return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+
+        Mask match_empty_or_deleted() const { return static_cast<Mask>(_mm_movemask_epi8(ctrl)); }
+#else
+        static constexpr size_t WIDTH = 16;
+        const ctrl_t *ctrl;
+
+        explicit Group(const ctrl_t *pos) : ctrl(pos) {}
+
+        Mask match(ctrl_t h2) const
+        {
+            Mask mask = 0;
+            for (size_t i = 0; i < WIDTH; ++i)
+                if (ctrl[i] == h2)
+                    mask |= Mask(1) << i;
+            return mask;
+        }
+
+        Mask match_empty_or_deleted() const
+        {
+            Mask mask = 0;
+            for (size_t i = 0; i < WIDTH; ++i)
+                if (ctrl[i] < 0)
+                    mask |= Mask(1) << i;
+            return mask;
+        }
+#endif
+
+        Mask match_empty() const { return match(EMPTY); }
+    };
+
+    KeyEqual key_equal_;
+    Hash hasher_;
+    size_t sz, number_of_deleted, number_of_groups;
+    float max_load_factor_;
+
+    std::vector<ctrl_t> ctrl;
+    std::vector<Slot> slots;
+
+    static auto lowest_bit(Mask mask) -> size_t
+    {
+        return static_cast<size_t>(__builtin_ctz(mask));
+    }
+
+    // Hashes such as std::hash<int> are the identity function, mix the bits so that both h1 and
+    // h2 depend on all bits of the hash
+    auto hash_of(const Key &key) const -> uint64_t
+    {
+        return mix64(static_cast<uint64_t>(hasher_(key)));
+    }
+
+    static auto h1(uint64_t hash) -> size_t { return static_cast<size_t>(hash >> 7); }
+
+    static auto h2(uint64_t hash) -> ctrl_t { return static_cast<ctrl_t>(hash & 0x7F); }
+
+    // Returns the index of the slot holding key, or capacity() if the key does not exist
+    auto find_index(const Key &key, uint64_t hash) const -> size_t
+    {
+        if (number_of_groups == 0)
+            return capacity();
+        size_t mask = number_of_groups - 1;
+        size_t group = h1(hash) & mask;
+        for (size_t i = 1;; ++i)
+        {
+            size_t base = group * Group::WIDTH;
+            Group g(ctrl.data() + base);
+            for (Mask m = g.match(h2(hash)); m; m &= m - 1)
+            {
+                size_t index = base + lowest_bit(m);
+                if (key_equal_(slots[index].k, key))
+                    return index;
+            }
+            // A key is never placed past a group which has an empty slot
+            if (g.match_empty())
+                return capacity();
+            if (i > number_of_groups)
+                return capacity();
+            group = (group + i) & mask;
+        }
+    }
+
+    // Returns the first EMPTY or DELETED slot in the probe sequence of hash
+    auto find_free_index(uint64_t hash) const -> size_t
+    {
+        size_t mask = number_of_groups - 1;
+        size_t group = h1(hash) & mask;
+        for (size_t i = 1;; ++i)
+        {
+            size_t base = group * Group::WIDTH;
+            Mask m = Group(ctrl.data() + base).match_empty_or_deleted();
+            if (m)
+                return base + lowest_bit(m);
+            group = (group + i) & mask;
+        }
+    }
+
+    // Rebuilds the table with new_groups groups, which also removes all DELETED markers
+    auto rehash(size_t new_groups) -> void
+    {
+        std::vector<ctrl_t> old_ctrl = std::move(ctrl);
+        std::vector<Slot> old_slots = std::move(slots);
+        ctrl.assign(new_groups * Group::WIDTH, EMPTY);
+        slots = std::vector<Slot>(new_groups * Group::WIDTH);
+        number_of_groups = new_groups;
+        number_of_deleted = 0;
+
+        for (size_t i = 0; i < old_ctrl.size(); ++i)
+        {
+            if (old_ctrl[i] < 0)
+                continue;
+            uint64_t hash = hash_of(old_slots[i].k);
+            size_t index = find_free_index(hash);
+            ctrl[index] = h2(hash);
+            slots[index] = std::move(old_slots[i]);
+        }
+    }
+
+    // Called before an insertion which uses a new slot
+    auto reserve_one() -> void
+    {
+        if (number_of_groups == 0)
+        {
+            rehash(1);
+            return;
+        }
+        if (static_cast<float>(sz + number_of_deleted + 1) <=
+            max_load_factor_ * static_cast<float>(capacity()))
+            return;
+        // If the table would be less than half full without the tombstones, clean them up instead
+        // of growing the table
+        if (static_cast<float>(sz) * 2 <= max_load_factor_ * static_cast<float>(capacity()))
+            rehash(number_of_groups);
+        else
+            rehash(number_of_groups * 2);
+    }
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.875f;
+    static constexpr size_t GROUP_WIDTH = Group::WIDTH;
+
+    SwissHashMap()
+        : sz(0), number_of_deleted(0), number_of_groups(0),
+          max_load_factor_(DEFAULT_MAX_LOAD_FACTOR)
+    {
+    }
+
+    auto find(const Key &key) const -> std::optional<Value>
+    {
+        auto index = find_index(key, hash_of(key));
+        if (index == capacity())
+            return std::nullopt;
+        return slots[index].v;
+    }
+
+    auto insert(const Key &key, const Value &value) -> void
+    {
+        uint64_t hash = hash_of(key);
+        auto index = find_index(key, hash);
+        // Overwrite the value if there is an existing key
+        if (index != capacity())
+        {
+            slots[index].v = value;
+            return;
+        }
+        reserve_one();
+        index = find_free_index(hash);
+        if (ctrl[index] == DELETED)
+            --number_of_deleted;
+        ctrl[index] = h2(hash);
+        slots[index].k = key;
+        slots[index].v = value;
+        ++sz;
+    }
+
+    auto erase(const Key &key) -> void
+    {
+        auto index = find_index(key, hash_of(key));
+        if (index == capacity())
+            return;
+        // Probing stops at the first group which has an empty slot, so if this group still has
+        // one, no probe sequence continues past it and the slot can be marked as empty again
+        size_t base = index - index % Group::WIDTH;
+        if (Group(ctrl.data() + base).match_empty())
+            ctrl[index] = EMPTY;
+        else
+        {
+            ctrl[index] = DELETED;
+            ++number_of_deleted;
+        }
+        slots[index] = Slot();
+        --sz;
+    }
+
+    auto contains(const Key &key) const -> bool
+    {
+        return find_index(key, hash_of(key)) != capacity();
+    }
+
+    auto size() const -> size_type { return sz; }
+
+    auto empty() const -> bool { return sz == 0; }
+
+    auto capacity() const -> size_type { return number_of_groups * Group::WIDTH; }
+
+    auto clear() -> void
+    {
+        ctrl.clear();
+        slots.clear();
+        sz = 0;
+        number_of_deleted = 0;
+        number_of_groups = 0;
+    }
+
+    auto load_factor() const -> float
+    {
+        if (number_of_groups)
+            return static_cast<float>(sz) / static_cast<float>(capacity());
+        return 0;
+    }
+
+    auto max_load_factor() const -> float { return max_load_factor_; }
+
+    auto max_load_factor(float new_max_load_factor) -> void
+    {
+        if (new_max_load_factor > 1.0f || new_max_load_factor <= 0.0f)
+            throw std::logic_error("Invalid Max load factor, it should be between 0 and 1");
+        max_load_factor_ = new_max_load_factor;
+    }
+};
+
+#endif // A_SWISS_HASHMAP_H
@@ -0,0 +1,109 @@
+#ifndef A_THREAD_POOL_H
+#define A_THREAD_POOL_H
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * ThreadPool
+ * ==========
+ * A fixed set of worker threads which run submitted tasks
+ * Design choices
+ * 1) All workers share one queue of tasks, protected by a mutex, and sleep on a condition variable
+ * while it is empty. The pool is meant for coarse tasks, such as building one partition of a hash
+ * table, so the shared queue is not a bottleneck
+ * 2) submit(fn) returns a std::future of the result of fn. An exception thrown by fn is stored in
+ * the future, and rethrown by get()
+ * 3) parallel_for(n, fn) runs fn(0), ..., fn(n - 1) on the workers and waits for all of them. It
+ * must not be called from a task of the same pool, as the waiting task would hold a worker
+ * 4) The destructor runs the tasks which are still queued, then joins the workers
+ */
+class ThreadPool
+{
+  private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    bool stopping;
+
+    auto work() -> void
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+  public:
+    // Starts thread_count workers, or one per hardware thread by default
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency()) : stopping(false)
+    {
+        if (thread_count == 0)
+            thread_count = 1;
+        workers.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        task_available.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    template <typename Fn> auto submit(Fn fn) -> std::future<std::invoke_result_t<Fn>>
+    {
+        // std::function must be copyable, so the packaged task is shared
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::move(fn));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task] { (*task)(); });
+        }
+        task_available.notify_one();
+        return result;
+    }
+
+    // Calls fn(i) for every i in [0, n) on the workers, and returns when all calls are done. If any
+    // call throws, the first exception is rethrown after all calls are done
+    template <typename Fn> auto parallel_for(size_t n, Fn fn) -> void
+    {
+        std::vector<std::future<void>> results;
+        results.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            results.push_back(submit([&fn, i] { fn(i); }));
+        for (auto &result : results)
+            result.wait();
+        for (auto &result : results)
+            result.get();
+    }
+
+    auto size() const -> size_t { return workers.size(); }
+};
+
+#endif // A_THREAD_POOL_H
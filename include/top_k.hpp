@@ -0,0 +1,103 @@
+#pragma once
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Keeps the K largest elements under Compare out of a stream, for example the best 1000 scores
+// out of billions
+//
+// The kept elements are in a PriorityQueue whose top is the smallest of them, the threshold. A new
+// element which is not larger than the threshold is rejected with one comparison, without touching
+// the heap, which is the fate of most elements of a long stream. A larger one replaces the
+// threshold with replace_top, a single sift down, instead of a push and a pop
+template <typename T, size_t K, typename Compare = std::less<T>> class TopK
+{
+    static_assert(K > 0, "TopK must keep at least one element");
+
+  private:
+    // Turns the max heap of PriorityQueue into a min heap of the kept elements
+    struct Reversed
+    {
+        Compare comp;
+
+        bool operator()(const T &a, const T &b) const { return comp(b, a); }
+    };
+
+    PriorityQueue<T, std::vector<T, CacheAlignedAllocator<T>>, Reversed> heap;
+    Compare comp;
+
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef Compare value_compare;
+    static constexpr size_t capacity = K;
+
+    explicit TopK(const Compare &compare = Compare()) : heap(Reversed{compare}), comp(compare) {}
+
+    size_type size() const { return heap.size(); }
+
+    bool empty() const { return heap.empty(); }
+
+    // The smallest kept element, which a new element must exceed once K elements are kept
+    const T &threshold() const { return heap.top(); }
+
+    // Returns true if value is kept, for now
+    bool offer(const T &value)
+    {
+        if (heap.size() < K)
+        {
+            heap.push(value);
+            return true;
+        }
+        if (!comp(heap.top(), value))
+            return false;
+        heap.replace_top(value);
+        return true;
+    }
+
+    // Offers the elements of [first, last). Once the heap is full, the threshold is kept in a local
+    // copy, which the compiler can hold in a register across the rejected elements
+    template <typename InputIt> void offer(InputIt first, InputIt last)
+    {
+        for (; first != last && heap.size() < K; ++first)
+            heap.push(*first);
+        if (first == last)
+            return;
+        T bar = heap.top();
+        for (; first != last; ++first)
+        {
+            if (comp(bar, *first))
+            {
+                heap.replace_top(*first);
+                bar = heap.top();
+            }
+        }
+    }
+
+    // Offers every element of other, for example to combine the results of several threads. Pass
+    // other with std::move when it is no longer needed, its heap is emptied by the merge
+    void merge(TopK other)
+    {
+        for (; !other.empty(); other.heap.pop())
+            offer(other.heap.top());
+    }
+
+    // The kept elements, largest first
+    std::vector<T> sorted() const
+    {
+        // The heap pops the smallest kept element first
+        auto copy = heap;
+        std::vector<T> result;
+        result.reserve(copy.size());
+        for (; !copy.empty(); copy.pop())
+            result.push_back(copy.top());
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    void clear() { heap = decltype(heap)(heap.value_comp()); }
+};
@@ -0,0 +1,67 @@
+// This program loads a large HashMap<uint64_t, uint64_t> in three ways and prints how long each
+// takes: a loop of insert, a serial bulk_build, and a bulk_build on a ThreadPool with one thread
+// per core. It then grows the table with a parallel rehash
+// $ g++ -O2 -std=c++17 -I../include threadpool.cpp -pthread && ./a.out [number of entries]
+#include "hashmap.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+
+using Map = HashMap<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                    PowerOfTwoCapacity>;
+
+template <typename F> static double seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    std::mt19937_64 rng(42);
+    std::vector<std::pair<uint64_t, uint64_t>> pairs(n);
+    for (size_t i = 0; i < n; i++)
+        pairs[i] = {rng(), i};
+
+    ThreadPool pool;
+    std::cout << n << " entries, " << pool.size() << " threads" << std::endl;
+
+    Map inserted;
+    std::cout << "insert loop:         "
+              << seconds(
+                     [&]
+                     {
+                         for (auto &pair : pairs)
+                             inserted.insert(pair.first, pair.second);
+                     })
+              << " s" << std::endl;
+
+    Map serial;
+    std::cout << "bulk_build:          "
+              << seconds([&] { serial.bulk_build(pairs.begin(), pairs.end()); }) << " s"
+              << std::endl;
+
+    Map parallel;
+    std::cout << "bulk_build (pool):   "
+              << seconds([&] { parallel.bulk_build(pairs.begin(), pairs.end(), pool); }) << " s"
+              << std::endl;
+
+    std::cout << "rehash x2 (pool):    "
+              << seconds([&] { parallel.rehash(parallel.capacity() * 2, pool); }) << " s"
+              << std::endl;
+
+    for (auto &pair : pairs)
+        if (parallel.find(pair.first) != pair.second || inserted.size() != parallel.size())
+        {
+            std::cerr << "Tables do not match" << std::endl;
+            return 1;
+        }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "bloom_filter.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <stdint.h>
+#include <string>
+
+TEST(BloomFilterTest, Empty)
+{
+    BloomFilter<int> f(100);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_FALSE(f.may_contain(i));
+}
+
+TEST(BloomFilterTest, NoFalseNegatives)
+{
+    BloomFilter<std::string> f(10000);
+    for (int i = 0; i < 10000; i++)
+        f.insert("key" + std::to_string(i));
+    for (int i = 0; i < 10000; i++)
+        ASSERT_TRUE(f.may_contain("key" + std::to_string(i)));
+}
+
+TEST(BloomFilterTest, FalsePositiveRate)
+{
+    const int n = 100000;
+    for (double bits_per_key : {8.0, 10.0, 16.0})
+    {
+        BloomFilter<uint64_t> f(n, bits_per_key);
+        ASSERT_GE(f.size_in_bytes() * 8, n * bits_per_key);
+        for (uint64_t i = 0; i < n; i++)
+            f.insert(i);
+        int false_positives = 0;
+        for (uint64_t i = n; i < 2 * n; i++)
+            false_positives += f.may_contain(i);
+        double rate = static_cast<double>(false_positives) / n;
+        // A blocked filter with k = 8 is about 1.5x worse than the standard bound
+        ASSERT_LT(rate, bits_per_key == 8 ? 0.04 : bits_per_key == 10 ? 0.02 : 0.003);
+    }
+}
+
+TEST(BloomFilterTest, Clear)
+{
+    BloomFilter<int> f(100);
+    f.insert(5);
+    ASSERT_TRUE(f.may_contain(5));
+    f.clear();
+    ASSERT_FALSE(f.may_contain(5));
+}
+
+TEST(BloomFilterTest, InvalidBitsPerKey)
+{
+    ASSERT_THROW(BloomFilter<int>(100, 0), std::logic_error);
+}
+
+TEST(BloomFilterTest, SaveAndLoad)
+{
+    BloomFilter<int> f(5000);
+    for (int i = 0; i < 5000; i++)
+        f.insert(i * 7);
+    std::stringstream stream;
+    f.save(stream);
+
+    auto loaded = BloomFilter<int>::load(stream);
+    ASSERT_EQ(loaded.number_of_blocks(), f.number_of_blocks());
+    for (int i = 0; i < 20000; i++)
+        ASSERT_EQ(loaded.may_contain(i), f.may_contain(i));
+}
+
+TEST(BloomFilterTest, LoadInvalid)
+{
+    std::stringstream garbage("not a bloom filter at all, but long enough");
+    ASSERT_THROW(BloomFilter<int>::load(garbage), std::runtime_error);
+
+    BloomFilter<int> f(5000);
+    std::stringstream stream;
+    f.save(stream);
+    std::stringstream truncated(stream.str().substr(0, stream.str().size() - 1));
+    ASSERT_THROW(BloomFilter<int>::load(truncated), std::runtime_error);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,9 @@
 #include "bst_set.hpp"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
 #include <set>
+#include <stdexcept>
 #include <vector>
 
 TEST(BST, TestEmpty)
@@ -313,6 +316,91 @@ TEST(BST, TestFind)
     }
 }
 
+TEST(BST, Clear)
+{
+    BSTSet<int> s;
+    for (int i = 0; i < 100; i++)
+        s.insert((i * 37) % 100);
+    s.clear();
+    ASSERT_TRUE(s.empty());
+    ASSERT_EQ(s.begin(), s.end());
+    s.insert(5);
+    ASSERT_EQ(s.size(), 1);
+    ASSERT_EQ(*s.begin(), 5);
+}
+
+TEST(BST, NodeAllocators)
+{
+    std::vector<int> elements = {1, 8, 3, 7, 6, 4, 0, -1, 5, 20, 24, 19, -20};
+    std::vector<int> sorted = elements;
+    std::sort(sorted.begin(), sorted.end());
+
+    PoolAllocator<int> pool(4);
+    BSTSet<int, std::less<int>, PoolAllocator<int>> pooled(pool);
+    for (const auto &e : elements)
+        pooled.insert(e);
+    ASSERT_EQ(std::vector<int>(pooled.begin(), pooled.end()), sorted);
+    ASSERT_EQ(pool.resource().slab_count(), 4);
+    pooled.clear();
+    for (const auto &e : elements)
+        pooled.insert(e);
+    ASSERT_EQ(pool.resource().slab_count(), 4);
+
+    BSTSet<int, std::less<int>, ArenaAllocator<int>> arena;
+    for (int round = 0; round < 3; round++)
+    {
+        arena.clear();
+        for (const auto &e : elements)
+            arena.insert(e);
+        ASSERT_EQ(std::vector<int>(arena.begin(), arena.end()), sorted);
+        ASSERT_EQ(arena.get_allocator().resource().block_count(), 1);
+    }
+
+    BSTSet<std::string, std::less<std::string>, ArenaAllocator<std::string>> strings;
+    strings.insert("b");
+    strings.insert("a");
+    ASSERT_EQ(*strings.begin(), "a");
+}
+
+// Throws when copied, if throws is set
+struct ThrowOnCopy
+{
+    int value;
+    bool throws;
+
+    ThrowOnCopy(int v, bool t) : value(v), throws(t) {}
+
+    ThrowOnCopy(const ThrowOnCopy &other) : value(other.value), throws(other.throws)
+    {
+        if (throws)
+            throw std::runtime_error("copy");
+    }
+
+    ThrowOnCopy &operator=(const ThrowOnCopy &) = default;
+
+    bool operator<(const ThrowOnCopy &other) const { return value < other.value; }
+
+    bool operator==(const ThrowOnCopy &other) const { return value == other.value; }
+};
+
+// A node whose key fails to copy goes back to the allocator. With one node per slab, a node which
+// was not returned would take a new slab on every attempt
+TEST(BST, ThrowingCopyReturnsNode)
+{
+    PoolAllocator<ThrowOnCopy> pool(1);
+    BSTSet<ThrowOnCopy, std::less<ThrowOnCopy>, PoolAllocator<ThrowOnCopy>> s(pool);
+    s.insert(ThrowOnCopy(2, false));
+    for (int i = 0; i < 10; i++)
+        ASSERT_THROW(s.insert(ThrowOnCopy(i % 2 ? 10 + i : -i, true)), std::runtime_error);
+    ASSERT_EQ(s.size(), 1);
+    ASSERT_EQ(pool.resource().slab_count(), 2);
+    s.insert(ThrowOnCopy(1, false));
+    s.insert(ThrowOnCopy(3, false));
+    ASSERT_EQ(s.size(), 3);
+    ASSERT_EQ(pool.resource().slab_count(), 3);
+    ASSERT_EQ((*s.begin()).value, 1);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,118 @@
+#include "concurrent_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentHashMapTest, Empty)
+{
+    ConcurrentHashMap<std::string, int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.find("Hello"), std::nullopt);
+    ASSERT_EQ(h.shard_count(), h.DEFAULT_NUMBER_OF_SHARDS);
+}
+
+TEST(ConcurrentHashMapTest, ShardCount)
+{
+    ConcurrentHashMap<int, int> one(1);
+    ASSERT_EQ(one.shard_count(), 1);
+    ConcurrentHashMap<int, int> h(10);
+    ASSERT_EQ(h.shard_count(), 16);
+    ASSERT_THROW((ConcurrentHashMap<int, int>(0)), std::logic_error);
+    for (int i = 0; i < 1000; i++)
+        one.insert(i, i);
+    ASSERT_EQ(one.size(), 1000);
+    ASSERT_EQ(one.find(999), 999);
+}
+
+TEST(ConcurrentHashMapTest, SingleThreadOperations)
+{
+    ConcurrentHashMap<std::string, int> h;
+    h.insert("Hello there", 58);
+    h.insert("Who are you?", 31);
+    h.insert("C++", 198339);
+    ASSERT_EQ(h.size(), 3);
+    ASSERT_EQ(h.find("Hello there"), 58);
+    ASSERT_TRUE(h.contains("C++"));
+    h.erase("C++");
+    ASSERT_FALSE(h.contains("C++"));
+    h.upsert("Who are you?", [](int &v) { v = -v; });
+    ASSERT_EQ(h.find("Who are you?"), -31);
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+}
+
+TEST(ConcurrentHashMapTest, ParallelInsertAndFind)
+{
+    ConcurrentHashMap<int, int> h;
+    const int number_of_threads = 8, per_thread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&h, t]()
+            {
+                for (int i = t * per_thread; i < (t + 1) * per_thread; i++)
+                    h.insert(i, i * 2);
+                for (int i = t * per_thread; i < (t + 1) * per_thread; i++)
+                    ASSERT_EQ(h.find(i), i * 2);
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(h.size(), number_of_threads * per_thread);
+    for (int i = 0; i < number_of_threads * per_thread; i++)
+        ASSERT_EQ(h.find(i), i * 2);
+}
+
+TEST(ConcurrentHashMapTest, ParallelUpsert)
+{
+    // Every thread increments the same counters, no increment should be lost
+    ConcurrentHashMap<int, long long> h(4);
+    const int number_of_threads = 8, increments = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&h]()
+            {
+                for (int i = 0; i < increments; i++)
+                    h.upsert(i % 100, [](long long &v) { ++v; });
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(h.size(), 100);
+    for (int i = 0; i < 100; i++)
+        ASSERT_EQ(h.find(i), number_of_threads * increments / 100);
+}
+
+TEST(ConcurrentHashMapTest, ParallelErase)
+{
+    ConcurrentHashMap<int, int> h;
+    for (int i = 0; i < 40000; i++)
+        h.insert(i, i);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back(
+            [&h, t]()
+            {
+                for (int i = t; i < 40000; i += 4)
+                    if (i % 2 == 0)
+                        h.erase(i);
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(h.size(), 20000);
+    for (int i = 0; i < 40000; i++)
+        ASSERT_EQ(h.contains(i), i % 2 == 1);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
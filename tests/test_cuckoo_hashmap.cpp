@@ -0,0 +1,193 @@
+#include "cuckoo_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+
+TEST(CuckooHashMapTest, Empty)
+{
+    CuckooHashMap<std::string, int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_EQ(h.find("Hello"), std::nullopt);
+    h.erase("Hello");
+    ASSERT_NEAR(h.max_load_factor(), h.DEFAULT_MAX_LOAD_FACTOR, 1e-5);
+}
+
+// A lookup reads two buckets, and the buckets of integer keys with up to 64 bytes of keys and
+// values fit in one cache line
+TEST(CuckooHashMapTest, BucketCacheLines)
+{
+    static_assert(CuckooHashMap<int, int>::BUCKET_CACHE_LINES == 1);
+    static_assert(CuckooHashMap<uint32_t, uint64_t>::BUCKET_CACHE_LINES == 1);
+    static_assert(CuckooHashMap<uint64_t, uint64_t>::BUCKET_CACHE_LINES == 1);
+    static_assert(
+        CuckooHashMap<int, int, std::hash<int>, std::equal_to<int>, 8>::BUCKET_CACHE_LINES == 1);
+    ASSERT_EQ((CuckooHashMap<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                             8>::BUCKET_CACHE_LINES),
+              2);
+    // Other keys have a tag byte per slot
+    ASSERT_GT((CuckooHashMap<std::string, int>::BUCKET_CACHE_LINES), 1);
+}
+
+// The largest integer marks empty slots, and is stored apart from the buckets
+TEST(CuckooHashMapTest, EmptyKey)
+{
+    const int empty = std::numeric_limits<int>::max();
+    CuckooHashMap<int, int> h;
+    h.insert(1, 10);
+    ASSERT_FALSE(h.contains(empty));
+    h.insert(empty, 20);
+    ASSERT_EQ(h.size(), 2);
+    ASSERT_EQ(h.find(empty), 20);
+    h.insert(empty, 30);
+    ASSERT_EQ(h.size(), 2);
+    ASSERT_EQ(h.find(empty), 30);
+    for (int i = 2; i < 1000; i++)
+        h.insert(i, i * 10);
+    ASSERT_EQ(h.find(empty), 30);
+    ASSERT_EQ(h.find(999), 9990);
+    h.erase(empty);
+    ASSERT_FALSE(h.contains(empty));
+    ASSERT_EQ(h.size(), 999);
+    h.erase(empty);
+    ASSERT_EQ(h.size(), 999);
+    h.insert(empty, 40);
+    h.clear();
+    ASSERT_FALSE(h.contains(empty));
+    ASSERT_EQ(h.size(), 0);
+}
+
+TEST(CuckooHashMapTest, InsertAndRetrieveValues)
+{
+    CuckooHashMap<std::string, int> h;
+    h.insert("Hello there", 58);
+    h.insert("Who are you?", 31);
+    h.insert("C++", 198339);
+    h.insert("XYZ", -88881);
+    ASSERT_EQ(h.size(), 4);
+    ASSERT_EQ(h.find("Hello there"), 58);
+    ASSERT_EQ(h.find("Who are you?"), 31);
+    ASSERT_EQ(h.find("C++"), 198339);
+    ASSERT_EQ(h.find("XYZ"), -88881);
+    ASSERT_EQ(h.find("Hello there "), std::nullopt);
+    h.insert("XYZ", 5);
+    ASSERT_EQ(h.find("XYZ"), 5);
+    ASSERT_EQ(h.size(), 4);
+}
+
+TEST(CuckooHashMapTest, LargeNumberOfValues)
+{
+    CuckooHashMap<int, long long int> h;
+    for (int i = 0; i < 780000; i++)
+        h.insert(i, static_cast<long long int>(i) * i);
+    ASSERT_EQ(h.size(), 780000);
+    for (int i = 0; i < 780000; i++)
+        ASSERT_EQ(h.find(i), static_cast<long long int>(i) * i);
+    ASSERT_FALSE(h.contains(-1));
+}
+
+template <size_t SlotsPerBucket> static float load_before_first_growth()
+{
+    // Fill a table until it grows, the load just before that is what the cuckoo moves reached
+    CuckooHashMap<int, int, std::hash<int>, std::equal_to<int>, SlotsPerBucket> h;
+    h.max_load_factor(1.0f);
+    for (int i = 0; i < 4096; i++)
+        h.insert(i, i);
+    auto capacity = h.capacity();
+    float load = h.load_factor();
+    for (int i = 4096; h.capacity() == capacity; i++)
+    {
+        load = h.load_factor();
+        h.insert(i, i);
+    }
+    for (int i = 0; i < static_cast<int>(h.size()); i++)
+        EXPECT_EQ(h.find(i), i);
+    return load;
+}
+
+TEST(CuckooHashMapTest, HighLoadFactor)
+{
+    ASSERT_GE(load_before_first_growth<4>(), 0.95f);
+    ASSERT_GE(load_before_first_growth<8>(), 0.95f);
+}
+
+TEST(CuckooHashMapTest, Erase)
+{
+    CuckooHashMap<int, std::string, std::hash<int>, std::equal_to<int>, 8> h;
+    for (int i = 0; i < 10000; i++)
+        h.insert(i, std::to_string(i));
+    for (int i = 0; i < 10000; i += 2)
+        h.erase(i);
+    h.erase(-1);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i++)
+    {
+        if (i % 2)
+            ASSERT_EQ(h.find(i), std::to_string(i));
+        else
+            ASSERT_FALSE(h.contains(i));
+    }
+    for (int i = 0; i < 10000; i += 2)
+        h.insert(i, "again");
+    ASSERT_EQ(h.size(), 10000);
+    ASSERT_EQ(h.find(42), "again");
+}
+
+TEST(CuckooHashMapTest, ChurnAtHighLoad)
+{
+    CuckooHashMap<int, int> h;
+    h.max_load_factor(1.0f);
+    for (int i = 0; i < 3800; i++)
+        h.insert(i, i);
+    for (int i = 3800; i < 50000; i++)
+    {
+        h.erase(i - 3800);
+        h.insert(i, -i);
+    }
+    ASSERT_EQ(h.size(), 3800);
+    ASSERT_LE(h.stash_size(), h.MAX_STASH_SIZE);
+    for (int i = 0; i < 50000 - 3800; i++)
+        ASSERT_FALSE(h.contains(i));
+    for (int i = 50000 - 3800; i < 50000; i++)
+        ASSERT_EQ(h.find(i), -i);
+}
+
+// Every key has the same two buckets, which no growth of the table can separate
+struct ConstantHash
+{
+    auto operator()(int) const -> size_t { return 42; }
+};
+
+TEST(CuckooHashMapTest, TooManyCollisions)
+{
+    CuckooHashMap<int, int, ConstantHash> h;
+    const size_t fit = 2 * h.SLOTS_PER_BUCKET + h.MAX_STASH_SIZE;
+    for (size_t i = 0; i < fit; i++)
+        h.insert(static_cast<int>(i), static_cast<int>(i));
+    ASSERT_THROW(h.insert(static_cast<int>(fit), 0), std::length_error);
+    // The keys which were placed are still there
+    ASSERT_EQ(h.size(), fit);
+    ASSERT_FALSE(h.contains(static_cast<int>(fit)));
+    for (size_t i = 0; i < fit; i++)
+        ASSERT_EQ(h.find(static_cast<int>(i)), static_cast<int>(i));
+}
+
+TEST(CuckooHashMapTest, Clear)
+{
+    CuckooHashMap<std::string, std::string> h;
+    h.insert("Hello", "World");
+    h.insert("C+", "+");
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_FALSE(h.contains("Hello"));
+    h.insert("Hello", "Again");
+    ASSERT_EQ(h.find("Hello"), "Again");
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
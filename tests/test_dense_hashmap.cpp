@@ -0,0 +1,131 @@
+#include "dense_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <array>
+#include <string>
+#include <vector>
+
+TEST(DenseHashMapTest, Empty)
+{
+    DenseHashMap<std::string, int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_EQ(h.find("Hello"), std::nullopt);
+    ASSERT_EQ(h.begin(), h.end());
+}
+
+TEST(DenseHashMapTest, InsertAndRetrieveValues)
+{
+    DenseHashMap<std::string, int> h;
+    h.insert("Hello there", 58);
+    h.insert("Who are you?", 31);
+    h.insert("C++", 198339);
+    h.insert("XYZ", -88881);
+    ASSERT_EQ(h.size(), 4);
+    ASSERT_EQ(h.find("Hello there"), 58);
+    ASSERT_EQ(h.find("Who are you?"), 31);
+    ASSERT_EQ(h.find("C++"), 198339);
+    ASSERT_EQ(h.find("XYZ"), -88881);
+    ASSERT_EQ(h.find("Hello there "), std::nullopt);
+    h.insert("C++", 17);
+    ASSERT_EQ(h.find("C++"), 17);
+    ASSERT_EQ(h.size(), 4);
+}
+
+TEST(DenseHashMapTest, InsertionOrder)
+{
+    DenseHashMap<int, int> h;
+    for (int i = 0; i < 1000; i++)
+        h.insert((i * 7919) % 1000, i);
+    int i = 0;
+    for (const auto &entry : h)
+    {
+        ASSERT_EQ(entry.first, (i * 7919) % 1000);
+        ASSERT_EQ(entry.second, i);
+        i++;
+    }
+    ASSERT_EQ(i, 1000);
+}
+
+TEST(DenseHashMapTest, LargeNumberOfValues)
+{
+    DenseHashMap<int, long long int> h;
+    for (int i = 0; i < 780000; i++)
+        h.insert(i, static_cast<long long int>(i) * i);
+    ASSERT_EQ(h.size(), 780000);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    for (int i = 0; i < 780000; i++)
+        ASSERT_EQ(h.find(i), static_cast<long long int>(i) * i);
+    ASSERT_FALSE(h.contains(-1));
+}
+
+TEST(DenseHashMapTest, Erase)
+{
+    DenseHashMap<int, std::string> h;
+    for (int i = 0; i < 10000; i++)
+        h.insert(i, std::to_string(i));
+    for (int i = 0; i < 10000; i += 2)
+        h.erase(i);
+    h.erase(-5);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i++)
+    {
+        if (i % 2)
+            ASSERT_EQ(h.find(i), std::to_string(i));
+        else
+            ASSERT_FALSE(h.contains(i));
+    }
+    // The entries are still contiguous, and each key appears once
+    std::vector<bool> seen(10000, false);
+    for (const auto &entry : h)
+    {
+        ASSERT_EQ(entry.first % 2, 1);
+        ASSERT_FALSE(seen[static_cast<size_t>(entry.first)]);
+        seen[static_cast<size_t>(entry.first)] = true;
+    }
+    for (int i = 1; i < 10000; i += 2)
+        h.erase(i);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.begin(), h.end());
+}
+
+TEST(DenseHashMapTest, LargeValues)
+{
+    DenseHashMap<int, std::array<char, 256>> h;
+    h.reserve(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        std::array<char, 256> value;
+        value.fill(static_cast<char>(i % 128));
+        h.insert(i, value);
+    }
+    for (int i = 0; i < 1000; i += 3)
+        h.erase(i);
+    for (int i = 0; i < 1000; i++)
+    {
+        auto value = h.find(i);
+        ASSERT_EQ(value.has_value(), i % 3 != 0);
+        if (value)
+        {
+            ASSERT_EQ((*value)[255], static_cast<char>(i % 128));
+        }
+    }
+}
+
+TEST(DenseHashMapTest, Clear)
+{
+    DenseHashMap<std::string, std::string> h;
+    h.insert("Hello", "World");
+    h.insert("C+", "+");
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_FALSE(h.contains("Hello"));
+    h.insert("Hello", "Again");
+    ASSERT_EQ(h.find("Hello"), "Again");
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
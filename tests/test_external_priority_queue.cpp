@@ -0,0 +1,134 @@
+#include "external_priority_queue.hpp"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+static std::string run_directory()
+{
+    auto directory = std::filesystem::path(::testing::TempDir()) / "dsa_external_priority_queue";
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+static size_t files_in(const std::string &directory)
+{
+    return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(directory),
+                                             std::filesystem::directory_iterator()));
+}
+
+TEST(ExternalPriorityQueueTest, Empty)
+{
+    ExternalPriorityQueue<int> pq(run_directory());
+    ASSERT_EQ(pq.size(), 0);
+    ASSERT_TRUE(pq.empty());
+    ASSERT_EQ(pq.run_count(), 0);
+    ASSERT_THROW((ExternalPriorityQueue<int>(run_directory(), 1024, 1024)), std::logic_error);
+}
+
+TEST(ExternalPriorityQueueTest, InMemory)
+{
+    ExternalPriorityQueue<int> pq(run_directory());
+    for (int value : {5, 3, 8, 1})
+        pq.push(value);
+    std::vector<int> order;
+    for (; !pq.empty(); pq.pop())
+        order.push_back(pq.top());
+    ASSERT_EQ(order, (std::vector<int>{8, 5, 3, 1}));
+    ASSERT_EQ(pq.run_count(), 0);
+}
+
+TEST(ExternalPriorityQueueTest, SpillsRuns)
+{
+    auto directory = run_directory();
+    {
+        // The insertion heap holds 512 elements, and 8 run buffers of 64 elements fit in the budget
+        ExternalPriorityQueue<int, std::greater<int>> pq(directory, 4096, 256);
+        for (int i = 0; i < 3000; i++)
+            pq.push((i * 7919) % 3000);
+        ASSERT_EQ(pq.size(), 3000);
+        ASSERT_GT(pq.run_count(), 0);
+        ASSERT_LE(pq.run_count(), 8);
+        ASSERT_EQ(files_in(directory), pq.run_count());
+        for (int i = 0; i < 1500; i++, pq.pop())
+            ASSERT_EQ(pq.top(), i);
+    }
+    ASSERT_EQ(files_in(directory), 0);
+}
+
+TEST(ExternalPriorityQueueTest, MergesRuns)
+{
+    auto directory = run_directory();
+    ExternalPriorityQueue<uint64_t> pq(directory, 4096, 512);
+    for (uint64_t i = 0; i < 20000; i++)
+        pq.push(i);
+    // 78 spills of 256 elements, with at most 4 runs at a time
+    ASSERT_LE(pq.run_count(), 4);
+    for (uint64_t i = 20000; i-- > 0; pq.pop())
+        ASSERT_EQ(pq.top(), i);
+    ASSERT_TRUE(pq.empty());
+    ASSERT_EQ(pq.run_count(), 0);
+    ASSERT_EQ(files_in(directory), 0);
+}
+
+TEST(ExternalPriorityQueueTest, BoundedMergeFanIn)
+{
+    // The insertion heap holds 512 elements, and at most 16 runs are kept, so 8 runs are merged at
+    // a time. Merging all runs on every overflow would write each element about 20 times, merging
+    // runs of similar size writes it at most 1 + log8(200) times
+    ExternalPriorityQueue<uint64_t> pq(run_directory(), 8192, 256);
+    const uint64_t n = 512 * 200;
+    for (uint64_t i = 0; i < n; i++)
+        pq.push((i * 7919) % n);
+    ASSERT_LE(pq.run_count(), 16);
+    ASSERT_LE(pq.bytes_written(), 4 * n * sizeof(uint64_t));
+    for (uint64_t i = n; i-- > 0; pq.pop())
+        ASSERT_EQ(pq.top(), i);
+    ASSERT_EQ(pq.run_count(), 0);
+}
+
+TEST(ExternalPriorityQueueTest, Random)
+{
+    struct Event
+    {
+        uint64_t time;
+        uint32_t id;
+
+        bool operator<(const Event &other) const
+        {
+            return time != other.time ? time < other.time : id < other.id;
+        }
+    };
+    std::mt19937_64 mt(11);
+    ExternalPriorityQueue<Event> pq(run_directory(), 8192, 512);
+    std::priority_queue<Event> reference;
+    for (uint32_t i = 0; i < 50000; i++)
+    {
+        if (mt() % 3 || reference.empty())
+        {
+            Event event{mt() % 100000, i};
+            pq.push(event);
+            reference.push(event);
+        }
+        else
+        {
+            ASSERT_EQ(pq.top().id, reference.top().id);
+            pq.pop();
+            reference.pop();
+        }
+        ASSERT_EQ(pq.size(), reference.size());
+    }
+    for (; !reference.empty(); reference.pop(), pq.pop())
+        ASSERT_EQ(pq.top().id, reference.top().id);
+    ASSERT_TRUE(pq.empty());
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
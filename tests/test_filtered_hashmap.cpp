@@ -0,0 +1,69 @@
+#include "filtered_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <string>
+
+TEST(FilteredHashMapTest, Empty)
+{
+    FilteredHashMap<std::string, int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.find("Hello"), std::nullopt);
+    ASSERT_FALSE(h.contains("Hello"));
+}
+
+TEST(FilteredHashMapTest, InsertFindErase)
+{
+    FilteredHashMap<int, int> h;
+    for (int i = 0; i < 100000; i++)
+        h.insert(i, i * 2);
+    h.insert(5, 7);
+    ASSERT_EQ(h.size(), 100000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(h.find(i), i == 5 ? 7 : i * 2);
+    for (int i = 100000; i < 200000; i++)
+        ASSERT_FALSE(h.contains(i));
+
+    for (int i = 0; i < 100000; i += 2)
+        h.erase(i);
+    h.erase(-1);
+    ASSERT_EQ(h.size(), 50000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(h.contains(i), i % 2 == 1);
+}
+
+TEST(FilteredHashMapTest, FilterFollowsTheTable)
+{
+    FilteredHashMap<int, int> h;
+    for (int i = 0; i < 10000; i++)
+        h.insert(i, i);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_TRUE(h.filter().may_contain(i));
+
+    // After enough erases the filter is rebuilt, and forgets most erased keys
+    for (int i = 0; i < 9000; i++)
+        h.erase(i);
+    int maybe = 0;
+    for (int i = 0; i < 9000; i++)
+        maybe += h.filter().may_contain(i);
+    ASSERT_LT(maybe, 900);
+    for (int i = 9000; i < 10000; i++)
+        ASSERT_EQ(h.find(i), i);
+}
+
+TEST(FilteredHashMapTest, Clear)
+{
+    FilteredHashMap<int, int> h(16);
+    ASSERT_EQ(h.bits_per_key(), 16);
+    h.insert(1, 1);
+    h.clear();
+    ASSERT_TRUE(h.empty());
+    ASSERT_FALSE(h.filter().may_contain(1));
+    h.insert(1, 2);
+    ASSERT_EQ(h.find(1), 2);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
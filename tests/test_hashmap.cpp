@@ -1,5 +1,11 @@
 #include "hashmap.hpp"
 #include "gtest/gtest.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 TEST(HashMapTest, Empty)
 {
@@ -17,6 +23,11 @@ TEST(HashMapTest, ModifyLoadFactor)
     h.max_load_factor(0.5f);
     ASSERT_NEAR(h.max_load_factor(), 0.5, 1e-5);
     ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_THROW(h.max_load_factor(0.0f), std::logic_error);
+    ASSERT_THROW(h.max_load_factor(-0.5f), std::logic_error);
+    ASSERT_THROW(h.max_load_factor(1.5f), std::logic_error);
+    h.max_load_factor(1.0f);
+    ASSERT_NEAR(h.max_load_factor(), 1.0, 1e-5);
 }
 
 TEST(HashMapTest, InsertAndRetrieveValues)
@@ -80,6 +91,599 @@ TEST(HashMapTest, UpdateOperation)
     ASSERT_EQ(kv.find("Empty"), "Not anymore");
 }
 
+TEST(HashMapTest, Contains)
+{
+    HashMap<std::string, int> h;
+    ASSERT_FALSE(h.contains("Hello there"));
+    h.insert("Hello there", 58);
+    h.insert("Who are you?", 31);
+    ASSERT_TRUE(h.contains("Hello there"));
+    ASSERT_TRUE(h.contains("Who are you?"));
+    ASSERT_FALSE(h.contains("Hello"));
+}
+
+TEST(HashMapTest, Erase)
+{
+    HashMap<int, int> h;
+    for (int i = 0; i < 10000; i++)
+        h.insert(i, i);
+    for (int i = 0; i < 10000; i += 2)
+        h.erase(i);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(h.contains(i), i % 2 == 1);
+    // Erasing keys which do not exist does nothing
+    h.erase(0);
+    h.erase(-1);
+    h.erase(10000);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i += 2)
+        h.insert(i, -i);
+    ASSERT_EQ(h.size(), 10000);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(h.find(i), i % 2 ? i : -i);
+}
+
+// Sends every key to one of a few home slots, so that the probe sequences are long and wrap around
+struct BadHash
+{
+    size_t operator()(int x) const { return static_cast<size_t>(x % 3) + 5; }
+};
+
+TEST(HashMapTest, EraseWithCollisions)
+{
+    HashMap<int, int, BadHash> h;
+    for (int i = 0; i < 300; i++)
+        h.insert(i, i * 7);
+    for (int i = 0; i < 300; i += 5)
+        h.erase(i);
+    ASSERT_EQ(h.size(), 240);
+    for (int i = 0; i < 300; i++)
+    {
+        if (i % 5 == 0)
+            ASSERT_EQ(h.find(i), std::nullopt);
+        else
+            ASSERT_EQ(h.find(i), i * 7);
+    }
+    for (int i = 0; i < 300; i++)
+        h.erase(i);
+    ASSERT_EQ(h.size(), 0);
+    for (int i = 0; i < 300; i++)
+        ASSERT_FALSE(h.contains(i));
+}
+
+TEST(HashMapTest, Churn)
+{
+    // Insert and evict keys while keeping the size constant, the table should not keep growing
+    HashMap<int, int> h;
+    for (int i = 0; i < 1000; i++)
+        h.insert(i, i);
+    auto load_factor = h.load_factor();
+    for (int i = 1000; i < 100000; i++)
+    {
+        h.erase(i - 1000);
+        h.insert(i, i);
+    }
+    ASSERT_EQ(h.size(), 1000);
+    ASSERT_NEAR(h.load_factor(), load_factor, 1e-5);
+    for (int i = 0; i < 99000; i++)
+        ASSERT_FALSE(h.contains(i));
+    for (int i = 99000; i < 100000; i++)
+        ASSERT_EQ(h.find(i), i);
+}
+
+TEST(HashMapTest, Clear)
+{
+    HashMap<std::string, std::string> h;
+    h.insert("Hello", "World");
+    h.insert("C+", "+");
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_FALSE(h.contains("Hello"));
+    ASSERT_EQ(h.find("C+"), std::nullopt);
+    h.insert("Hello", "Again");
+    ASSERT_EQ(h.find("Hello"), "Again");
+    ASSERT_EQ(h.size(), 1);
+}
+
+TEST(HashMapTest, Upsert)
+{
+    HashMap<std::string, int> h;
+    h.upsert("a", [](int &v) { v += 5; });
+    ASSERT_EQ(h.find("a"), 5);
+    h.upsert("a", [](int &v) { v *= 3; });
+    ASSERT_EQ(h.find("a"), 15);
+    ASSERT_EQ(h.size(), 1);
+
+    // Count the words, the table grows while upserting
+    HashMap<int, int> counts;
+    for (int i = 0; i < 10000; i++)
+        counts.upsert(i % 1000, [](int &v) { ++v; });
+    ASSERT_EQ(counts.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(counts.find(i), 10);
+}
+
+TEST(HashMapTest, IncrementalRehash)
+{
+    HashMap<int, int> h;
+    h.rehash_step(4);
+    ASSERT_EQ(h.rehash_step(), 4);
+    bool was_rehashing = false;
+    for (int i = 0; i < 100000; i++)
+    {
+        h.insert(i, i);
+        was_rehashing = was_rehashing || h.is_rehashing();
+        // Keys inserted before the resize should be visible while it is in progress
+        if (i % 97 == 0)
+        {
+            ASSERT_EQ(h.find(i / 2), i / 2);
+        }
+    }
+    ASSERT_TRUE(was_rehashing);
+    ASSERT_EQ(h.size(), 100000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(h.find(i), i);
+    ASSERT_FALSE(h.is_rehashing());
+}
+
+// Even with the smallest step, the previous move is over before the table grows again, so no
+// insert has to move a whole table
+TEST(HashMapTest, IncrementalRehashEndsBeforeNextGrow)
+{
+    HashMap<int, int> h, batched;
+    h.rehash_step(1);
+    batched.rehash_step(1);
+    size_t grows = 0;
+    std::vector<int> keys, values;
+    for (int i = 0; i < 200000; i++)
+    {
+        size_t capacity = h.capacity();
+        bool was_rehashing = h.is_rehashing();
+        h.insert(i, i);
+        if (h.capacity() != capacity)
+        {
+            ++grows;
+            ASSERT_FALSE(was_rehashing) << "at insert " << i;
+        }
+        keys.push_back(i);
+        values.push_back(i);
+        if (keys.size() == 37)
+        {
+            capacity = batched.capacity();
+            was_rehashing = batched.is_rehashing();
+            batched.insert_batch(keys.data(), values.data(), keys.size());
+            // A small table may have to grow twice for a single batch
+            if (batched.capacity() != capacity && capacity > 16 * keys.size())
+            {
+                ASSERT_FALSE(was_rehashing) << "at batch ending with " << i;
+            }
+            keys.clear();
+            values.clear();
+        }
+    }
+    ASSERT_GT(grows, 10);
+    for (int i = 0; i < 200000; i++)
+        ASSERT_EQ(h.find(i), i);
+}
+
+TEST(HashMapTest, IncrementalRehashModifications)
+{
+    HashMap<int, int, BadHash> colliding;
+    HashMap<std::string, int> h;
+    colliding.rehash_step(1);
+    h.rehash_step(2);
+    for (int i = 0; i < 3000; i++)
+    {
+        colliding.insert(i, i);
+        h.insert(std::to_string(i), i);
+        // Update, erase and upsert keys which may still be in the old table
+        if (i % 3 == 0)
+        {
+            colliding.erase(i / 2);
+            h.erase(std::to_string(i / 2));
+        }
+        if (i % 5 == 0)
+        {
+            colliding.insert(i / 4, -1);
+            h.upsert(std::to_string(i / 4), [](int &v) { v = -1; });
+        }
+    }
+
+    HashMap<int, int> expected;
+    for (int i = 0; i < 3000; i++)
+    {
+        expected.insert(i, i);
+        if (i % 3 == 0)
+            expected.erase(i / 2);
+        if (i % 5 == 0)
+            expected.insert(i / 4, -1);
+    }
+    ASSERT_EQ(h.size(), expected.size());
+    ASSERT_EQ(colliding.size(), expected.size());
+    for (int i = 0; i < 3000; i++)
+    {
+        ASSERT_EQ(colliding.find(i), expected.find(i));
+        ASSERT_EQ(h.find(std::to_string(i)), expected.find(i));
+    }
+
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_FALSE(h.is_rehashing());
+    ASSERT_FALSE(h.contains("10"));
+}
+
+TEST(HashMapTest, FindBatch)
+{
+    HashMap<int, int> h;
+    std::vector<int> keys(1000);
+    std::vector<int *> out(keys.size(), &keys[0]);
+    // Nothing is found in an empty table
+    h.find_batch(keys.data(), keys.size(), out.data());
+    for (auto ptr : out)
+        ASSERT_EQ(ptr, nullptr);
+
+    for (int i = 0; i < 5000; i += 2)
+        h.insert(i, i * 10);
+    for (size_t i = 0; i < keys.size(); i++)
+        keys[i] = static_cast<int>(i * 5);
+    h.find_batch(keys.data(), keys.size(), out.data());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] < 5000 && keys[i] % 2 == 0)
+        {
+            ASSERT_NE(out[i], nullptr);
+            ASSERT_EQ(*out[i], keys[i] * 10);
+        }
+        else
+            ASSERT_EQ(out[i], nullptr);
+    }
+    // The values can be modified through the pointers
+    *out[0] = -1;
+    ASSERT_EQ(h.find(0), -1);
+}
+
+TEST(HashMapTest, InsertBatch)
+{
+    HashMap<std::string, int> h;
+    std::vector<std::string> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 10000; i++)
+    {
+        keys.push_back(std::to_string(i % 7000));
+        values.push_back(i);
+    }
+    h.insert_batch(keys.data(), values.data(), keys.size());
+    ASSERT_EQ(h.size(), 7000);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    // Later values overwrite earlier values of the same key
+    for (int i = 0; i < 7000; i++)
+        ASSERT_EQ(h.find(std::to_string(i)), i < 3000 ? i + 7000 : i);
+}
+
+// A block of new keys can need several grows of a small table with a small growth factor
+TEST(HashMapTest, InsertBatchLoadFactor)
+{
+    HashMap<int, int> h;
+    h.growth_factor(0.1f);
+    h.max_load_factor(0.95f);
+    std::vector<int> keys, values;
+    for (int i = 0; i < 1000; i++)
+    {
+        keys.push_back(i);
+        values.push_back(i);
+    }
+    for (size_t i = 0; i < keys.size(); i += 50)
+    {
+        h.insert_batch(keys.data() + i, values.data() + i, 50);
+        ASSERT_LE(h.load_factor(), h.max_load_factor());
+    }
+    ASSERT_EQ(h.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(h.find(i), i);
+}
+
+TEST(HashMapTest, BatchDuringIncrementalRehash)
+{
+    HashMap<int, int> h;
+    h.rehash_step(1);
+    std::vector<int> keys, values;
+    for (int i = 0; i < 20000; i++)
+    {
+        keys.push_back(i);
+        values.push_back(-i);
+    }
+    for (size_t i = 0; i < keys.size(); i += 100)
+    {
+        h.insert_batch(keys.data() + i, values.data() + i, 100);
+        std::vector<int *> out(i + 100);
+        h.find_batch(keys.data(), i + 100, out.data());
+        for (size_t j = 0; j < i + 100; j++)
+        {
+            ASSERT_NE(out[j], nullptr);
+            ASSERT_EQ(*out[j], -keys[j]);
+        }
+    }
+    ASSERT_EQ(h.size(), 20000);
+}
+
+template <typename Policy> class HashMapPolicyTest : public ::testing::Test
+{
+};
+
+using CapacityPolicies = ::testing::Types<ModuloCapacity, PowerOfTwoCapacity, FastRangeCapacity>;
+TYPED_TEST_SUITE(HashMapPolicyTest, CapacityPolicies);
+
+TYPED_TEST(HashMapPolicyTest, InsertFindErase)
+{
+    HashMap<int, int, std::hash<int>, std::equal_to<int>, TypeParam> h;
+    for (int i = 0; i < 100000; i++)
+        h.insert(i, -i);
+    ASSERT_EQ(h.size(), 100000);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    for (int i = 0; i < 100000; i += 3)
+        h.erase(i);
+    for (int i = 0; i < 100000; i++)
+    {
+        if (i % 3 == 0)
+            ASSERT_FALSE(h.contains(i));
+        else
+            ASSERT_EQ(h.find(i), -i);
+    }
+}
+
+TYPED_TEST(HashMapPolicyTest, GrowthFactor)
+{
+    HashMap<std::string, int, std::hash<std::string>, std::equal_to<std::string>, TypeParam> h;
+    h.growth_factor(0.5f);
+    h.rehash_step(3);
+    for (int i = 0; i < 20000; i++)
+        h.insert(std::to_string(i), i);
+    for (int i = 0; i < 20000; i++)
+        ASSERT_EQ(h.find(std::to_string(i)), i);
+}
+
+TEST(HashMapTest, PowerOfTwoCapacity)
+{
+    HashMap<int, int, std::hash<int>, std::equal_to<int>, PowerOfTwoCapacity> h;
+    h.growth_factor(0.5f);
+    for (int i = 0; i < 5000; i++)
+    {
+        h.insert(i * 1024, i);
+        // The capacity is always a power of two
+        ASSERT_EQ(h.capacity() & (h.capacity() - 1), 0);
+    }
+    // Keys which are multiples of a power of two are still spread over the table
+    for (int i = 0; i < 5000; i++)
+        ASSERT_EQ(h.find(i * 1024), i);
+}
+
+TEST(HashMapTest, CapacityPolicyIndex)
+{
+    for (size_t size : {1, 2, 8, 64, 1024})
+    {
+        PowerOfTwoCapacity p;
+        p.reset(size);
+        for (size_t hash = 0; hash < 5000; hash++)
+            ASSERT_LT(p.index(hash), size);
+    }
+    for (size_t size : {1, 3, 7, 100, 1000})
+    {
+        FastRangeCapacity f;
+        f.reset(size);
+        for (size_t hash = 0; hash < 5000; hash++)
+            ASSERT_LT(f.index(hash), size);
+        ASSERT_LT(f.index(SIZE_MAX), size);
+    }
+}
+
+TEST(HashMapTest, Stats)
+{
+    HashMap<int, int, BadHash, std::equal_to<int>, ModuloCapacity, HashMapStats> h;
+    for (int i = 0; i < 300; i++)
+        h.insert(i, i);
+    const auto &stats = h.stats();
+    // The table starts with 8 slots and doubles, 300 keys need 7 grows
+    ASSERT_EQ(stats.grow_seconds.size(), 7);
+    // Every key hashes to one of 3 home slots, so the keys are displaced a lot
+    ASSERT_GE(stats.max_displacement, 100);
+
+    for (int i = 0; i < 400; i++)
+        h.find(i);
+    ASSERT_TRUE(h.contains(5));
+    uint64_t hits = 0, misses = 0;
+    for (size_t i = 0; i < HashMapStats::HISTOGRAM_SIZE; i++)
+    {
+        hits += stats.hit_probe_lengths[i];
+        misses += stats.miss_probe_lengths[i];
+    }
+    ASSERT_EQ(hits, 301);
+    ASSERT_EQ(misses, 100);
+    // Long probe sequences are counted in the last bucket
+    ASSERT_GT(stats.hit_probe_lengths[HashMapStats::HISTOGRAM_SIZE - 1], 0);
+
+    std::stringstream ss;
+    h.dump_stats(ss);
+    ASSERT_NE(ss.str().find("Grow calls: 7"), std::string::npos);
+    ASSERT_NE(ss.str().find("Misses: 100 finds"), std::string::npos);
+
+    h.reset_stats();
+    ASSERT_EQ(stats.grow_seconds.size(), 0);
+    ASSERT_EQ(stats.max_displacement, 0);
+}
+
+TEST(HashMapTest, StatsDisabled)
+{
+    // Without statistics, dump_stats only prints the shape of the table
+    HashMap<int, int> h;
+    for (int i = 0; i < 100; i++)
+        h.insert(i, i);
+    std::stringstream ss;
+    h.dump_stats(ss);
+    ASSERT_NE(ss.str().find("Size: 100"), std::string::npos);
+    ASSERT_EQ(ss.str().find("Grow calls"), std::string::npos);
+    // and the disabled statistics take no storage
+    ASSERT_TRUE(std::is_empty<HashMapStatsStorage<NoHashMapStats>>::value);
+    ASSERT_FALSE(std::is_empty<HashMapStatsStorage<HashMapStats>>::value);
+}
+
+TEST(HashMapTest, FindPtr)
+{
+    HashMap<int, std::vector<int>> h;
+    h.insert(1, {1, 2, 3});
+    ASSERT_EQ(h.find_ptr(2), nullptr);
+    auto value = h.find_ptr(1);
+    ASSERT_NE(value, nullptr);
+    value->push_back(4);
+    ASSERT_EQ(h.find(1), std::vector<int>({1, 2, 3, 4}));
+
+    const auto &c = h;
+    const std::vector<int> *const_value = c.find_ptr(1);
+    ASSERT_EQ(const_value->size(), 4);
+}
+
+TEST(HashMapTest, StringHash)
+{
+    StringHash hash;
+    std::string s = "The quick brown fox jumps over the lazy dog";
+    ASSERT_EQ(hash(s), hash(std::string_view(s)));
+    ASSERT_EQ(hash(s), hash(s.c_str()));
+    ASSERT_EQ(hash(""), hash(std::string()));
+    // Every length up to 100 bytes is read by a different mix of loads, a change of any byte must
+    // change the hash
+    std::string bytes;
+    for (size_t length = 0; length < 100; length++)
+    {
+        auto h = hash(bytes);
+        for (size_t i = 0; i < length; i++)
+        {
+            std::string changed = bytes;
+            changed[i] ^= 1;
+            ASSERT_NE(hash(changed), h);
+        }
+        bytes.push_back(static_cast<char>('a' + length % 26));
+        ASSERT_NE(hash(bytes), h);
+    }
+    ASSERT_NE(WyHash::hash(s.data(), s.size(), 1), WyHash::hash(s.data(), s.size(), 2));
+
+    // Test vectors of the reference implementation, the seed is the index of the string
+    const char *inputs[] = {"", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz"};
+    uint64_t expected[] = {0x93228a4de0eec5a2ULL, 0xc5bac3db178713c4ULL, 0xa97f2f7b1d9b3314ULL,
+                           0x786d1f1df3801df4ULL, 0xdca5a8138ad37c87ULL};
+    for (uint64_t i = 0; i < 5; i++)
+        ASSERT_EQ(WyHash::hash(inputs[i], std::string_view(inputs[i]).size(), i), expected[i]);
+}
+
+TEST(HashMapTest, HeterogeneousLookup)
+{
+    HashMap<std::string, int, StringHash, std::equal_to<>> h;
+    h.insert("Hello there", 58);
+    h.insert(std::string(40, 'x'), 31);
+    std::string_view view = "Hello there";
+    ASSERT_EQ(h.find(view), 58);
+    ASSERT_EQ(h.find("Hello there"), 58);
+    ASSERT_EQ(h.find(std::string_view("Hello")), std::nullopt);
+    ASSERT_TRUE(h.contains(std::string_view(std::string(40, 'x'))));
+    ASSERT_FALSE(h.contains("x"));
+    *h.find_ptr(view) = 7;
+    ASSERT_EQ(h.find(std::string("Hello there")), 7);
+
+    const auto &c = h;
+    ASSERT_EQ(*c.find_ptr("Hello there"), 7);
+    ASSERT_EQ(c.find(view), 7);
+}
+
+TEST(HashMapTest, BulkBuild)
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 100000; i++)
+        pairs.emplace_back(i * 3, i);
+    // Duplicate keys, the last value wins
+    for (int i = 0; i < 1000; i++)
+        pairs.emplace_back(i * 3, -i);
+
+    ThreadPool pool(4);
+    HashMap<int, int> h;
+    h.insert(-1, 5);
+    h.insert(0, 5);
+    h.bulk_build(pairs.begin(), pairs.end(), pool);
+    ASSERT_EQ(h.size(), 100001);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    ASSERT_EQ(h.find(-1), 5);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(h.find(i * 3), i < 1000 ? -i : i);
+    ASSERT_EQ(h.find(1), std::nullopt);
+
+    HashMap<int, int> serial;
+    serial.bulk_build(pairs.begin(), pairs.end());
+    ASSERT_EQ(serial.size(), 100000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(serial.find(i * 3), i < 1000 ? -i : i);
+}
+
+// Groups of 32 consecutive keys share a home slot, so the clusters often cross the end of a
+// partition
+struct ClusteredHash
+{
+    size_t operator()(int key) const { return static_cast<size_t>(key / 32) * 45; }
+};
+
+TEST(HashMapTest, BulkBuildOverflow)
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 100000; i++)
+        pairs.emplace_back(i, i);
+    ThreadPool pool(4);
+    HashMap<int, int, ClusteredHash> clustered;
+    clustered.bulk_build(pairs.begin(), pairs.end(), pool);
+    ASSERT_EQ(clustered.size(), 100000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(clustered.find(i), i);
+    clustered.bulk_build(pairs.begin(), pairs.begin() + 1000, pool);
+    ASSERT_EQ(clustered.size(), 100000);
+
+    // Every key has the same hash, so the entries wrap around the end of the table
+    pairs.resize(2000);
+    HashMap<int, int, BadHash> h;
+    h.bulk_build(pairs.begin(), pairs.end(), pool);
+    ASSERT_EQ(h.size(), 2000);
+    for (int i = 0; i < 2000; i++)
+        ASSERT_EQ(h.find(i), i);
+
+    HashMap<int, int, std::hash<int>, std::equal_to<int>, PowerOfTwoCapacity> p;
+    for (int i = 0; i < 2000; i++)
+        pairs.emplace_back(i + 1000000, i);
+    p.bulk_build(pairs.begin(), pairs.end(), pool);
+    ASSERT_EQ(p.size(), 4000);
+    for (auto &pair : pairs)
+        ASSERT_EQ(p.find(pair.first), pair.second);
+}
+
+TEST(HashMapTest, Rehash)
+{
+    ThreadPool pool(3);
+    HashMap<int, std::string> h;
+    h.rehash_step(4);
+    for (int i = 0; i < 50000; i++)
+        h.insert(i, std::to_string(i));
+    h.rehash(1 << 20, pool);
+    ASSERT_FALSE(h.is_rehashing());
+    ASSERT_EQ(h.capacity(), 1 << 20);
+    ASSERT_EQ(h.size(), 50000);
+    for (int i = 0; i < 50000; i++)
+        ASSERT_EQ(h.find(i), std::to_string(i));
+
+    // Shrinking stops at the size needed by the entries
+    h.rehash(0);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    ASSERT_LT(h.capacity(), 1 << 20);
+    for (int i = 0; i < 50000; i++)
+        ASSERT_EQ(h.find(i), std::to_string(i));
+    h.insert(50000, "x");
+    ASSERT_EQ(h.find(50000), "x");
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
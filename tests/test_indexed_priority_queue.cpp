@@ -0,0 +1,153 @@
+#include "indexed_priority_queue.hpp"
+#include "gtest/gtest.h"
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+TEST(IndexedPriorityQ, Empty)
+{
+    IndexedPriorityQueue<int> pq;
+    ASSERT_EQ(pq.size(), 0);
+    ASSERT_TRUE(pq.empty());
+    ASSERT_FALSE(pq.contains(0));
+    ASSERT_FALSE(pq.contains(1000));
+}
+
+TEST(IndexedPriorityQ, PushPop)
+{
+    IndexedPriorityQueue<int> pq(4);
+    pq.push(0, 5);
+    pq.push(1, 3);
+    pq.push(2, 8);
+    pq.push(10, 1);
+    ASSERT_EQ(pq.size(), 4);
+    ASSERT_TRUE(pq.contains(10));
+    ASSERT_EQ(pq.priority(2), 8);
+    ASSERT_THROW(pq.push(1, 7), std::logic_error);
+
+    std::vector<std::pair<size_t, int>> order;
+    while (!pq.empty())
+    {
+        order.emplace_back(pq.top_handle(), pq.top_priority());
+        pq.pop();
+    }
+    std::vector<std::pair<size_t, int>> expected = {{10, 1}, {1, 3}, {0, 5}, {2, 8}};
+    ASSERT_EQ(order, expected);
+    ASSERT_FALSE(pq.contains(0));
+}
+
+TEST(IndexedPriorityQ, ChangeKeys)
+{
+    IndexedPriorityQueue<int> pq;
+    for (size_t i = 0; i < 10; i++)
+        pq.push(i, static_cast<int>(i) * 10);
+    pq.decrease_key(7, -1);
+    ASSERT_EQ(pq.top_handle(), 7);
+    pq.increase_key(7, 100);
+    ASSERT_EQ(pq.top_handle(), 0);
+    pq.increase_key(0, 45);
+    ASSERT_EQ(pq.top_handle(), 1);
+    pq.update(9, 0);
+    ASSERT_EQ(pq.top_handle(), 9);
+    ASSERT_THROW(pq.decrease_key(9, 5), std::logic_error);
+    ASSERT_THROW(pq.increase_key(9, -5), std::logic_error);
+    ASSERT_THROW(pq.update(42, 5), std::logic_error);
+}
+
+TEST(IndexedPriorityQ, Erase)
+{
+    IndexedPriorityQueue<int, std::less<int>, 4> pq;
+    for (size_t i = 0; i < 100; i++)
+        pq.push(i, static_cast<int>((i * 37) % 100));
+    for (size_t i = 0; i < 100; i += 3)
+        pq.erase(i);
+    ASSERT_THROW(pq.erase(0), std::logic_error);
+    int previous = -1;
+    size_t count = 0;
+    while (!pq.empty())
+    {
+        ASSERT_NE(pq.top_handle() % 3, 0);
+        ASSERT_GT(pq.top_priority(), previous);
+        previous = pq.top_priority();
+        pq.pop();
+        count++;
+    }
+    ASSERT_EQ(count, 66);
+}
+
+TEST(IndexedPriorityQ, RandomOperations)
+{
+    // Compare against a std::set of (priority, handle) pairs
+    IndexedPriorityQueue<int, std::less<int>, 8> pq;
+    std::set<std::pair<int, size_t>> reference;
+    std::map<size_t, int> priorities;
+    uint32_t x = 7;
+    for (int step = 0; step < 20000; step++)
+    {
+        x = x * 1664525u + 1013904223u;
+        size_t handle = (x >> 8) % 200;
+        int priority = static_cast<int>((x >> 16) % 1000);
+        if (!pq.contains(handle))
+        {
+            pq.push(handle, priority);
+            reference.insert({priority, handle});
+            priorities[handle] = priority;
+        }
+        else if (x & 1)
+        {
+            pq.update(handle, priority);
+            reference.erase({priorities[handle], handle});
+            reference.insert({priority, handle});
+            priorities[handle] = priority;
+        }
+        else
+        {
+            pq.erase(handle);
+            reference.erase({priorities[handle], handle});
+        }
+        ASSERT_EQ(pq.size(), reference.size());
+        if (!pq.empty())
+        {
+            ASSERT_EQ(pq.top_priority(), reference.begin()->first);
+        }
+    }
+    pq.clear();
+    ASSERT_TRUE(pq.empty());
+    ASSERT_FALSE(pq.contains(reference.begin()->second));
+}
+
+TEST(IndexedPriorityQ, Dijkstra)
+{
+    // Each vertex is in the queue at most once, its distance is lowered with decrease_key
+    std::vector<std::vector<std::pair<size_t, int>>> graph = {
+        {{1, 4}, {2, 1}}, {{3, 1}}, {{1, 2}, {3, 5}}, {{4, 3}}, {}};
+    std::vector<int> distance(graph.size(), std::numeric_limits<int>::max());
+    IndexedPriorityQueue<int> pq(graph.size());
+    distance[0] = 0;
+    pq.push(0, 0);
+    while (!pq.empty())
+    {
+        size_t u = pq.top_handle();
+        pq.pop();
+        for (auto [v, weight] : graph[u])
+        {
+            if (distance[u] + weight >= distance[v])
+                continue;
+            bool queued = distance[v] != std::numeric_limits<int>::max();
+            distance[v] = distance[u] + weight;
+            if (queued && pq.contains(v))
+                pq.decrease_key(v, distance[v]);
+            else
+                pq.push(v, distance[v]);
+        }
+    }
+    ASSERT_EQ(distance, std::vector<int>({0, 3, 1, 4, 7}));
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+#include "int_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <stdint.h>
+#include <unordered_map>
+
+TEST(IntHashMapTest, Empty)
+{
+    IntHashMap<uint64_t, uint32_t> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_EQ(h.find(42), std::nullopt);
+    ASSERT_FALSE(h.contains(h.EMPTY_KEY));
+}
+
+TEST(IntHashMapTest, InsertAndRetrieveValues)
+{
+    IntHashMap<uint64_t, uint32_t> h;
+    h.insert(0, 58);
+    h.insert(17, 31);
+    h.insert(1ULL << 40, 198339);
+    ASSERT_EQ(h.size(), 3);
+    ASSERT_EQ(h.find(0), 58u);
+    ASSERT_EQ(h.find(17), 31u);
+    ASSERT_EQ(h.find(1ULL << 40), 198339u);
+    ASSERT_EQ(h.find(18), std::nullopt);
+    h.insert(17, 4);
+    ASSERT_EQ(h.find(17), 4u);
+    ASSERT_EQ(h.size(), 3);
+}
+
+TEST(IntHashMapTest, EmptyKeyIsReserved)
+{
+    IntHashMap<uint32_t, int> h;
+    ASSERT_THROW(h.insert(UINT32_MAX, 1), std::logic_error);
+    ASSERT_EQ(h.size(), 0);
+
+    IntHashMap<int, int, 0> zero_empty;
+    ASSERT_THROW(zero_empty.insert(0, 1), std::logic_error);
+    zero_empty.insert(-1, 1);
+    ASSERT_EQ(zero_empty.find(-1), 1);
+}
+
+TEST(IntHashMapTest, SignedKeys)
+{
+    // INT_MAX is not a repeated byte, so the table is initialized key by key
+    IntHashMap<int, int> h;
+    for (int i = -5000; i < 5000; i++)
+        h.insert(i, i * 2);
+    ASSERT_EQ(h.size(), 10000);
+    for (int i = -5000; i < 5000; i++)
+        ASSERT_EQ(h.find(i), i * 2);
+    ASSERT_EQ(h.find(5000), std::nullopt);
+}
+
+TEST(IntHashMapTest, Growth)
+{
+    IntHashMap<uint64_t, uint64_t> h;
+    for (uint64_t i = 0; i < 100000; i++)
+        h.insert(i * 64, i);
+    ASSERT_EQ(h.size(), 100000);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    // Capacity stays a power of two
+    ASSERT_EQ(h.capacity() & (h.capacity() - 1), 0);
+    for (uint64_t i = 0; i < 100000; i++)
+        ASSERT_EQ(h.find(i * 64), i);
+}
+
+TEST(IntHashMapTest, Erase)
+{
+    IntHashMap<uint64_t, uint32_t> h;
+    for (uint32_t i = 0; i < 1000; i++)
+        h.insert(i, i);
+    for (uint32_t i = 0; i < 1000; i += 2)
+        h.erase(i);
+    h.erase(5000);
+    ASSERT_EQ(h.size(), 500);
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        if (i % 2)
+            ASSERT_EQ(h.find(i), i);
+        else
+            ASSERT_FALSE(h.contains(i));
+    }
+}
+
+TEST(IntHashMapTest, Churn)
+{
+    // Compare against std::unordered_map with interleaved inserts and erases, so that clusters
+    // wrap around the end of the table and backward shifts cross it
+    IntHashMap<uint32_t, uint32_t> h;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    uint32_t x = 12345;
+    for (uint32_t i = 0; i < 200000; i++)
+    {
+        x = x * 1664525u + 1013904223u;
+        uint32_t key = (x >> 8) % 512;
+        if (x & 1)
+        {
+            h.insert(key, i);
+            reference[key] = i;
+        }
+        else
+        {
+            h.erase(key);
+            reference.erase(key);
+        }
+    }
+    ASSERT_EQ(h.size(), reference.size());
+    for (uint32_t key = 0; key < 512; key++)
+    {
+        auto it = reference.find(key);
+        if (it == reference.end())
+            ASSERT_EQ(h.find(key), std::nullopt);
+        else
+            ASSERT_EQ(h.find(key), it->second);
+    }
+}
+
+TEST(IntHashMapTest, Clear)
+{
+    IntHashMap<uint64_t, uint32_t> h;
+    for (uint32_t i = 0; i < 100; i++)
+        h.insert(i, i);
+    auto capacity = h.capacity();
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_EQ(h.capacity(), capacity);
+    ASSERT_EQ(h.find(3), std::nullopt);
+    h.insert(3, 9);
+    ASSERT_EQ(h.find(3), 9u);
+}
+
+TEST(IntHashMapTest, MaxLoadFactor)
+{
+    IntHashMap<uint64_t, uint32_t> h;
+    ASSERT_THROW(h.max_load_factor(1.0f), std::logic_error);
+    ASSERT_THROW(h.max_load_factor(0.0f), std::logic_error);
+    h.max_load_factor(0.9f);
+    ASSERT_EQ(h.max_load_factor(), 0.9f);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
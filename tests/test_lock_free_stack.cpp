@@ -0,0 +1,234 @@
+#include "lock_free_stack.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(LockFreeStackTest, Empty)
+{
+    LockFreeStack<int> s;
+    int value;
+    ASSERT_TRUE(s.empty());
+    ASSERT_FALSE(s.try_pop(value));
+}
+
+TEST(LockFreeStackTest, PushPop)
+{
+    LockFreeStack<std::string> s(1);
+    s.push("a");
+    std::string b = "b";
+    s.push(b);
+    s.push(std::string("c"));
+    ASSERT_FALSE(s.empty());
+    std::string value;
+    for (const char *expected : {"c", "b", "a"})
+    {
+        ASSERT_TRUE(s.try_pop(value));
+        ASSERT_EQ(value, expected);
+    }
+    ASSERT_FALSE(s.try_pop(value));
+}
+
+TEST(LockFreeStackTest, PushBulk)
+{
+    LockFreeStack<int> s;
+    s.push(0);
+    std::vector<int> values = {1, 2, 3, 4};
+    s.push_bulk(values.begin(), values.end());
+    s.push_bulk(values.end(), values.end());
+    int value;
+    for (int expected = 4; expected >= 0; expected--)
+    {
+        ASSERT_TRUE(s.try_pop(value));
+        ASSERT_EQ(value, expected);
+    }
+    ASSERT_TRUE(s.empty());
+}
+
+TEST(LockFreeStackTest, FreesEveryNode)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        LockFreeStack<std::shared_ptr<int>> s(2);
+        for (int i = 0; i < 1000; i++)
+            s.push(counter);
+        std::shared_ptr<int> value;
+        // Enough pops to free retired nodes in batches, and leave some retired and some in the
+        // stack
+        for (int i = 0; i < 500; i++)
+            ASSERT_TRUE(s.try_pop(value));
+        value.reset();
+        ASSERT_EQ(counter.use_count(), 501);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+// Counts the live objects, and throws when copied or move assigned from, if asked to
+struct Fragile
+{
+    static int live;
+    int value;
+    bool copy_throws, move_throws;
+
+    Fragile(int v = 0, bool c = false, bool m = false) : value(v), copy_throws(c), move_throws(m)
+    {
+        ++live;
+    }
+
+    Fragile(const Fragile &other)
+        : value(other.value), copy_throws(other.copy_throws), move_throws(other.move_throws)
+    {
+        if (copy_throws)
+            throw std::runtime_error("copy");
+        ++live;
+    }
+
+    Fragile &operator=(Fragile &&other)
+    {
+        if (other.move_throws)
+            throw std::runtime_error("move");
+        value = other.value;
+        return *this;
+    }
+
+    ~Fragile() { --live; }
+};
+
+int Fragile::live = 0;
+
+TEST(LockFreeStackTest, ThrowingMoveKeepsSlot)
+{
+    {
+        LockFreeStack<Fragile> s(1);
+        s.push(Fragile(1));
+        s.push(Fragile(2, false, true));
+        Fragile out;
+        // The popped node is retired, and the slot is released
+        ASSERT_THROW(s.try_pop(out), std::runtime_error);
+        ASSERT_EQ(s.retired_count(), 1);
+        ASSERT_TRUE(s.try_pop(out));
+        ASSERT_EQ(out.value, 1);
+        ASSERT_EQ(s.slot_count(), 1);
+    }
+    ASSERT_EQ(Fragile::live, 0);
+}
+
+TEST(LockFreeStackTest, ThrowingPushBulkFreesChain)
+{
+    {
+        LockFreeStack<Fragile> s;
+        s.push(Fragile(0));
+        std::vector<Fragile> values;
+        values.reserve(4);
+        for (int i = 1; i <= 4; i++)
+            values.emplace_back(i, i == 3);
+        ASSERT_THROW(s.push_bulk(values.begin(), values.end()), std::runtime_error);
+        Fragile out;
+        ASSERT_TRUE(s.try_pop(out));
+        ASSERT_EQ(out.value, 0);
+        ASSERT_TRUE(s.empty());
+    }
+    ASSERT_EQ(Fragile::live, 0);
+}
+
+// Every thread pushes its own values and pops whatever it finds, as in a shared pool of work. No
+// value is lost or popped twice
+TEST(LockFreeStackTest, ParallelPushAndPop)
+{
+    const int number_of_threads = 8, per_thread = 20000;
+    LockFreeStack<int> s(4);
+    std::vector<std::atomic<int>> popped(number_of_threads * per_thread);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                int value;
+                for (int i = t * per_thread; i < (t + 1) * per_thread; i += 4)
+                {
+                    if (i % 8)
+                    {
+                        std::vector<int> batch = {i, i + 1, i + 2, i + 3};
+                        s.push_bulk(batch.begin(), batch.end());
+                    }
+                    else
+                        for (int j = i; j < i + 4; j++)
+                            s.push(j);
+                    for (int j = 0; j < 3; j++)
+                        if (s.try_pop(value))
+                            popped[value]++;
+                }
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    int value;
+    while (s.try_pop(value))
+        popped[value]++;
+    for (auto &count : popped)
+        ASSERT_EQ(count, 1);
+}
+
+// With more poppers than slots, try_pop adds slots instead of waiting, up to one per thread
+TEST(LockFreeStackTest, MoreThreadsThanSlots)
+{
+    const int number_of_threads = 8, per_thread = 5000;
+    LockFreeStack<int> s(1);
+    std::atomic<int> popped(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+        threads.emplace_back(
+            [&]()
+            {
+                int value;
+                for (int i = 0; i < per_thread; i++)
+                {
+                    s.push(i);
+                    if (s.try_pop(value))
+                        popped++;
+                }
+            });
+    for (auto &thread : threads)
+        thread.join();
+    int value;
+    while (s.try_pop(value))
+        popped++;
+    ASSERT_EQ(popped, number_of_threads * per_thread);
+    ASSERT_GE(s.slot_count(), 1);
+    ASSERT_LE(s.slot_count(), number_of_threads);
+}
+
+// Nodes retired into slots which are not taken again are freed by the batches of other slots
+TEST(LockFreeStackTest, FreesNodesOfIdleSlots)
+{
+    const int number_of_threads = 4, per_thread = 5000;
+    LockFreeStack<int> s(8);
+    for (int i = 0; i < number_of_threads * per_thread; i++)
+        s.push(i);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+        threads.emplace_back(
+            [&]()
+            {
+                int value;
+                for (int i = 0; i < per_thread / 2; i++)
+                    s.try_pop(value);
+            });
+    for (auto &thread : threads)
+        thread.join();
+    // A single thread only ever takes the first slot, and its batches take over the others
+    int value;
+    for (size_t i = 0; i < 4 * s.slot_count(); i++)
+        ASSERT_TRUE(s.try_pop(value));
+    ASSERT_LT(s.retired_count(), 2 * s.slot_count());
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,210 @@
+#include "mapped_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+
+static std::string snapshot_path(const std::string &name)
+{
+    return ::testing::TempDir() + "dsa_" + name + ".snapshot";
+}
+
+TEST(MappedHashMapTest, SaveAndOpen)
+{
+    HashMap<int, long long int> h;
+    for (int i = 0; i < 100000; i++)
+        h.insert(i, static_cast<long long int>(i) * i);
+    for (int i = 0; i < 100000; i += 3)
+        h.erase(i);
+    auto path = snapshot_path("save_and_open");
+    h.save(path);
+
+    auto m = MappedHashMap<int, long long int>::open_mapped(path);
+    ASSERT_EQ(m.size(), h.size());
+    ASSERT_EQ(m.capacity(), h.capacity());
+    ASSERT_NEAR(m.load_factor(), h.load_factor(), 1e-5);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(m.find(i), h.find(i));
+    ASSERT_FALSE(m.contains(-1));
+    ASSERT_FALSE(m.contains(100000));
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, EmptyTable)
+{
+    HashMap<int, int> h;
+    auto path = snapshot_path("empty");
+    h.save(path);
+    auto m = MappedHashMap<int, int>::open_mapped(path);
+    ASSERT_TRUE(m.empty());
+    ASSERT_EQ(m.find(0), std::nullopt);
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, PolicyAndIncrementalRehash)
+{
+    // A resize which is still in progress is completed before saving
+    HashMap<uint64_t, double, std::hash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoCapacity> h;
+    h.rehash_step(1);
+    for (uint64_t i = 0; i < 5000; i++)
+        h.insert(i << 20, static_cast<double>(i) / 2);
+    auto path = snapshot_path("policy");
+    h.save(path);
+    ASSERT_FALSE(h.is_rehashing());
+
+    auto m = MappedHashMap<uint64_t, double, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                           PowerOfTwoCapacity>::open_mapped(path);
+    ASSERT_EQ(m.size(), 5000);
+    for (uint64_t i = 0; i < 5000; i++)
+        ASSERT_EQ(m.find(i << 20), static_cast<double>(i) / 2);
+
+    // The view can be moved, and outlives the table which was saved
+    auto moved = std::move(m);
+    h.clear();
+    ASSERT_EQ(moved.find(uint64_t(7) << 20), 3.5);
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, InvalidFiles)
+{
+    ASSERT_THROW((MappedHashMap<int, int>::open_mapped(snapshot_path("does_not_exist"))),
+                 std::system_error);
+
+    auto path = snapshot_path("invalid");
+    {
+        std::ofstream out(path);
+        out << "This is not a hash table, but it is long enough to hold a header of one.";
+    }
+    ASSERT_THROW((MappedHashMap<int, int>::open_mapped(path)), std::runtime_error);
+
+    // The value type does not match
+    HashMap<int, int> h;
+    h.insert(1, 2);
+    h.save(path);
+    ASSERT_THROW((MappedHashMap<int, long long int>::open_mapped(path)), std::runtime_error);
+    ASSERT_EQ((MappedHashMap<int, int>::open_mapped(path).find(1)), 2);
+
+    // A capacity so large that capacity * slot_size wraps around to a small number
+    HashMapSnapshotHeader header;
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    }
+    header.capacity = UINT64_MAX / header.slot_size + 1;
+    {
+        std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+        io.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    ASSERT_THROW((MappedHashMap<int, int>::open_mapped(path)), std::runtime_error);
+    header.slots_offset = UINT64_MAX;
+    header.capacity = 1;
+    {
+        std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+        io.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    ASSERT_THROW((MappedHashMap<int, int>::open_mapped(path)), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// Writes header over the start of the file at path
+static void write_header(const std::string &path, const HashMapSnapshotHeader &header)
+{
+    std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+    io.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+TEST(MappedHashMapTest, InvalidSizeOrCapacity)
+{
+    HashMap<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoCapacity> h;
+    for (uint64_t i = 0; i < 10; i++)
+        h.insert(i, static_cast<int>(i));
+    auto path = snapshot_path("invalid_size");
+    h.save(path);
+    using Mapped = MappedHashMap<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                 PowerOfTwoCapacity>;
+    HashMapSnapshotHeader saved;
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char *>(&saved), sizeof(saved));
+    }
+    ASSERT_EQ(Mapped::open_mapped(path).find(3), 3);
+
+    // Elements in a table without slots
+    auto header = saved;
+    header.capacity = 0;
+    write_header(path, header);
+    ASSERT_THROW(Mapped::open_mapped(path), std::runtime_error);
+
+    // More elements than slots
+    header = saved;
+    header.size = header.capacity + 1;
+    write_header(path, header);
+    ASSERT_THROW(Mapped::open_mapped(path), std::runtime_error);
+
+    // A capacity which is not a power of two
+    header = saved;
+    header.capacity = saved.capacity - 1;
+    write_header(path, header);
+    ASSERT_THROW(Mapped::open_mapped(path), std::runtime_error);
+
+    // Slots which would not be aligned, or would not start where they were saved
+    header = saved;
+    header.slots_offset = saved.slots_offset + 1;
+    write_header(path, header);
+    ASSERT_THROW(Mapped::open_mapped(path), std::runtime_error);
+    header.slots_offset = saved.slots_offset + alignof(uint64_t);
+    write_header(path, header);
+    ASSERT_THROW(Mapped::open_mapped(path), std::runtime_error);
+
+    write_header(path, saved);
+    ASSERT_EQ(Mapped::open_mapped(path).find(3), 3);
+    std::remove(path.c_str());
+
+    // With the modulo policy, a table without slots holding elements is rejected too
+    HashMap<int, int> m;
+    m.insert(1, 2);
+    m.save(path);
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    }
+    header.capacity = 0;
+    write_header(path, header);
+    ASSERT_THROW((MappedHashMap<int, int>::open_mapped(path)), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// A seeded hash, which places the keys in other slots than std::hash<uint64_t>
+struct SeededHash
+{
+    uint64_t seed = 12345;
+
+    auto operator()(uint64_t key) const -> size_t { return static_cast<size_t>(key ^ seed); }
+};
+
+TEST(MappedHashMapTest, MismatchedPolicyOrHash)
+{
+    HashMap<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoCapacity> h;
+    for (uint64_t i = 0; i < 100; i++)
+        h.insert(i, static_cast<int>(i));
+    auto path = snapshot_path("mismatch");
+    h.save(path);
+    ASSERT_THROW((MappedHashMap<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                FastRangeCapacity>::open_mapped(path)),
+                 std::runtime_error);
+    ASSERT_THROW((MappedHashMap<uint64_t, int>::open_mapped(path)), std::runtime_error);
+    ASSERT_THROW((MappedHashMap<uint64_t, int, SeededHash, std::equal_to<uint64_t>,
+                                PowerOfTwoCapacity>::open_mapped(path)),
+                 std::runtime_error);
+    auto m = MappedHashMap<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                           PowerOfTwoCapacity>::open_mapped(path);
+    ASSERT_EQ(m.find(99), 99);
+    std::remove(path.c_str());
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
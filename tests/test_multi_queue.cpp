@@ -0,0 +1,209 @@
+#include "multi_queue.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(MultiQueueTest, Empty)
+{
+    MultiQueue<int> q(4);
+    int value = 0;
+    ASSERT_TRUE(q.empty());
+    ASSERT_EQ(q.size(), 0);
+    ASSERT_FALSE(q.try_pop(value));
+    ASSERT_EQ(q.heap_count(), 4 * q.DEFAULT_HEAPS_PER_THREAD);
+}
+
+TEST(MultiQueueTest, HeapCount)
+{
+    ASSERT_EQ((MultiQueue<int>(1, 1).heap_count()), 2);
+    ASSERT_EQ((MultiQueue<int>(8, 4).heap_count()), 32);
+    ASSERT_THROW((MultiQueue<int>(4, 0)), std::logic_error);
+}
+
+TEST(MultiQueueTest, PopsEveryElement)
+{
+    MultiQueue<int> q(2);
+    for (int i = 0; i < 1000; i++)
+        q.push(i);
+    ASSERT_EQ(q.size(), 1000);
+    std::vector<int> popped;
+    int value;
+    while (q.try_pop(value))
+        popped.push_back(value);
+    ASSERT_TRUE(q.empty());
+    std::sort(popped.begin(), popped.end());
+    ASSERT_EQ(popped.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(popped[i], i);
+}
+
+struct PointeeLess
+{
+    bool operator()(const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) const
+    {
+        return *a < *b;
+    }
+};
+
+// Elements are moved out of the heaps, so move only elements can be queued
+TEST(MultiQueueTest, MoveOnly)
+{
+    MultiQueue<std::unique_ptr<int>, PointeeLess> q(2);
+    for (int i = 0; i < 100; i++)
+        q.push(std::make_unique<int>(i));
+    std::vector<int> popped;
+    std::unique_ptr<int> value;
+    while (q.try_pop(value))
+        popped.push_back(*value);
+    ASSERT_TRUE(q.empty());
+    std::sort(popped.begin(), popped.end());
+    ASSERT_EQ(popped.size(), 100);
+    for (int i = 0; i < 100; i++)
+        ASSERT_EQ(popped[i], i);
+}
+
+// With a single thread, the rank of a popped element (the number of smaller elements still in the
+// queue) is on average a small multiple of the number of heaps
+TEST(MultiQueueTest, RankError)
+{
+    MultiQueue<int, std::greater<int>> q(4);
+    const int n = 20000;
+    for (int i = 0; i < n; i++)
+        q.push(i);
+    std::vector<bool> popped(n, false);
+    int value, smallest = 0;
+    long long total_rank = 0;
+    while (q.try_pop(value))
+    {
+        for (int i = smallest; i < value; i++)
+            total_rank += !popped[i];
+        popped[value] = true;
+        while (smallest < n && popped[smallest])
+            smallest++;
+    }
+    ASSERT_EQ(smallest, n);
+    ASSERT_LT(static_cast<double>(total_rank) / n, 4.0 * static_cast<double>(q.heap_count()));
+}
+
+TEST(MultiQueueTest, ParallelPushAndPop)
+{
+    const int number_of_threads = 8, per_thread = 20000;
+    MultiQueue<int> q(number_of_threads);
+    std::atomic<long long> popped_sum(0);
+    std::atomic<int> popped_count(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                long long sum = 0;
+                int count = 0, value;
+                for (int i = t * per_thread; i < (t + 1) * per_thread; i++)
+                {
+                    q.push(i);
+                    if (i % 2 && q.try_pop(value))
+                    {
+                        sum += value;
+                        count++;
+                    }
+                }
+                popped_sum += sum;
+                popped_count += count;
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    int value;
+    long long sum = popped_sum;
+    int count = popped_count;
+    while (q.try_pop(value))
+    {
+        sum += value;
+        count++;
+    }
+    const long long n = number_of_threads * per_thread;
+    ASSERT_EQ(count, n);
+    ASSERT_EQ(sum, n * (n - 1) / 2);
+    ASSERT_TRUE(q.empty());
+}
+
+// A comparator whose order is chosen at run time
+struct FlippableLess
+{
+    bool reversed = false;
+
+    bool operator()(int a, int b) const { return reversed ? b < a : a < b; }
+};
+
+// Every heap orders its elements with the comparator given to the queue
+TEST(MultiQueueTest, StatefulComparator)
+{
+    // With two heaps, try_pop nearly always compares both tops, and pops the smallest element
+    MultiQueue<int, FlippableLess> q(1, 1, FlippableLess{true});
+    const int n = 1000;
+    for (int i = n - 1; i >= 0; i--)
+        q.push(i);
+    int value, in_order = 0;
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT_TRUE(q.try_pop(value));
+        in_order += value == i;
+    }
+    ASSERT_TRUE(q.empty());
+    ASSERT_GT(in_order, n * 9 / 10);
+}
+
+// Throws from its move constructor while throw_on_move is set
+struct ThrowingValue
+{
+    static bool throw_on_move;
+    int value;
+
+    explicit ThrowingValue(int v = 0) : value(v) {}
+
+    ThrowingValue(const ThrowingValue &other) = default;
+
+    ThrowingValue(ThrowingValue &&other) : value(other.value)
+    {
+        if (throw_on_move)
+            throw std::runtime_error("move failed");
+    }
+
+    ThrowingValue &operator=(const ThrowingValue &other) = default;
+
+    ThrowingValue &operator=(ThrowingValue &&other) = default;
+
+    bool operator<(const ThrowingValue &other) const { return value < other.value; }
+};
+
+bool ThrowingValue::throw_on_move = false;
+
+TEST(MultiQueueTest, PushThrows)
+{
+    MultiQueue<ThrowingValue> q(1, 1);
+    ThrowingValue::throw_on_move = true;
+    ASSERT_THROW(q.push(ThrowingValue(1)), std::runtime_error);
+    ThrowingValue::throw_on_move = false;
+    // The failed push is not counted, and the lock of its heap was released
+    ASSERT_EQ(q.size(), 0);
+    ThrowingValue out;
+    ASSERT_FALSE(q.try_pop(out));
+    for (int i = 0; i < 10; i++)
+        q.push(ThrowingValue(i));
+    int count = 0;
+    while (q.try_pop(out))
+        count++;
+    ASSERT_EQ(count, 10);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
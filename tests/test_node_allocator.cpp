@@ -0,0 +1,87 @@
+#include "node_allocator.hpp"
+#include "gtest/gtest.h"
+#include <list>
+#include <stdint.h>
+#include <vector>
+
+TEST(NodeAllocatorTest, PoolReusesNodes)
+{
+    PoolAllocator<uint64_t> pool(8);
+    std::vector<uint64_t *> nodes;
+    for (int i = 0; i < 20; i++)
+        nodes.push_back(pool.allocate(1));
+    ASSERT_EQ(pool.resource().slab_count(), 3);
+    // Nodes of one slab are consecutive
+    ASSERT_EQ(nodes[1], nodes[0] + 1);
+    for (auto *node : nodes)
+        pool.deallocate(node, 1);
+    for (int i = 0; i < 20; i++)
+        nodes[i] = pool.allocate(1);
+    ASSERT_EQ(pool.resource().slab_count(), 3);
+    for (auto *node : nodes)
+        pool.deallocate(node, 1);
+    // Arrays, and objects of another size, do not come from the pool
+    uint64_t *array = pool.allocate(10);
+    pool.deallocate(array, 10);
+    PoolAllocator<char> rebound(pool);
+    ASSERT_EQ(rebound, pool);
+    char *c = rebound.allocate(1);
+    rebound.deallocate(c, 1);
+    ASSERT_EQ(pool.resource().slab_count(), 3);
+    ASSERT_NE(PoolAllocator<uint64_t>(), pool);
+}
+
+TEST(NodeAllocatorTest, ArenaAlignment)
+{
+    ArenaAllocator<char> arena(64);
+    char *c = arena.allocate(3);
+    ArenaAllocator<double> doubles(arena);
+    double *d = doubles.allocate(2);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+    ASSERT_GE(reinterpret_cast<char *>(d), c + 3);
+    // A request larger than a block gets its own block
+    long double *big = ArenaAllocator<long double>(arena).allocate(100);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(big) % alignof(long double), 0);
+    big[99] = 1;
+    ASSERT_EQ(arena.resource().block_count(), 2);
+}
+
+TEST(NodeAllocatorTest, ArenaClear)
+{
+    ArenaAllocator<int> arena(1024);
+    int *first = arena.allocate(1);
+    for (int i = 0; i < 1000; i++)
+        arena.allocate(1);
+    size_t blocks = arena.resource().block_count();
+    ArenaAllocator<int> copy(arena);
+    // Shared with copy, so not cleared
+    arena.clear_if_unshared();
+    ASSERT_NE(arena.allocate(1), first);
+    copy = ArenaAllocator<int>();
+    arena.clear_if_unshared();
+    ASSERT_EQ(arena.allocate(1), first);
+    for (int i = 0; i < 1000; i++)
+        arena.allocate(1);
+    ASSERT_EQ(arena.resource().block_count(), blocks);
+}
+
+TEST(NodeAllocatorTest, StandardContainers)
+{
+    std::list<int, PoolAllocator<int>> pooled;
+    std::list<int, ArenaAllocator<int>> arena;
+    for (int i = 0; i < 1000; i++)
+    {
+        pooled.push_back(i);
+        arena.push_front(i);
+    }
+    ASSERT_EQ(pooled.back(), 999);
+    ASSERT_EQ(arena.back(), 0);
+    pooled.clear();
+    ASSERT_TRUE(pooled.empty());
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+#include "pairing_heap.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST(PairingHeapTest, Empty)
+{
+    PairingHeap<int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+    ASSERT_EQ(h.pool_capacity(), 0);
+}
+
+TEST(PairingHeapTest, PushPop)
+{
+    PairingHeap<int> h;
+    for (int value : {5, 3, 8, 3, 1, 9, 0})
+        h.push(value);
+    ASSERT_EQ(h.size(), 7);
+    std::vector<int> order;
+    while (!h.empty())
+    {
+        order.push_back(h.top());
+        h.pop();
+    }
+    std::vector<int> expected = {0, 1, 3, 3, 5, 8, 9};
+    ASSERT_EQ(order, expected);
+}
+
+TEST(PairingHeapTest, MaxHeap)
+{
+    PairingHeap<std::string, std::greater<std::string>> h;
+    h.push("b");
+    h.emplace(3, 'a');
+    h.push("c");
+    ASSERT_EQ(h.top(), "c");
+    h.pop();
+    ASSERT_EQ(h.top(), "b");
+    h.pop();
+    ASSERT_EQ(h.top(), "aaa");
+}
+
+TEST(PairingHeapTest, DecreaseKey)
+{
+    PairingHeap<int> h;
+    std::vector<PairingHeap<int>::handle> handles;
+    for (int i = 0; i < 100; i++)
+        handles.push_back(h.push(1000 + i));
+    h.decrease_key(handles[50], 5);
+    ASSERT_EQ(h.top(), 5);
+    ASSERT_EQ(h.value(handles[50]), 5);
+    ASSERT_THROW(h.decrease_key(handles[10], 2000), std::logic_error);
+    h.pop();
+    // Decreasing the children of the root, and elements deep in the tree
+    for (int i = 99; i >= 60; i--)
+        h.decrease_key(handles[i], i);
+    h.decrease_key(handles[0], 1);
+    std::vector<int> order;
+    while (!h.empty())
+    {
+        order.push_back(h.top());
+        h.pop();
+    }
+    ASSERT_EQ(order.size(), 99);
+    ASSERT_TRUE(std::is_sorted(order.begin(), order.end()));
+    ASSERT_EQ(order[0], 1);
+    ASSERT_EQ(order[1], 60);
+}
+
+TEST(PairingHeapTest, Meld)
+{
+    PairingHeap<int> a, b;
+    std::vector<PairingHeap<int>::handle> handles;
+    for (int i = 0; i < 1000; i++)
+    {
+        a.push(2 * i);
+        handles.push_back(b.push(2 * i + 1));
+    }
+    size_t capacity = a.pool_capacity() + b.pool_capacity();
+    a.meld(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(b.pool_capacity(), 0);
+    ASSERT_EQ(a.size(), 2000);
+    ASSERT_EQ(a.pool_capacity(), capacity);
+    // The handles of b refer to elements of a
+    a.decrease_key(handles[999], -1);
+    ASSERT_EQ(a.top(), -1);
+    a.pop();
+    for (int i = 0; i < 1999; i++)
+    {
+        ASSERT_EQ(a.top(), i);
+        a.pop();
+    }
+    ASSERT_TRUE(a.empty());
+    // b still works after giving away its nodes
+    b.push(7);
+    ASSERT_EQ(b.top(), 7);
+    a.meld(a);
+    a.meld(b);
+    ASSERT_EQ(a.top(), 7);
+}
+
+TEST(PairingHeapTest, PoolReuse)
+{
+    PairingHeap<int> h;
+    for (int i = 0; i < 1000; i++)
+        h.push(i);
+    size_t capacity = h.pool_capacity();
+    for (int round = 0; round < 10; round++)
+    {
+        for (int i = 0; i < 500; i++)
+            h.pop();
+        for (int i = 0; i < 500; i++)
+            h.push(i);
+    }
+    h.clear();
+    ASSERT_TRUE(h.empty());
+    for (int i = 0; i < 1000; i++)
+        h.push(i);
+    ASSERT_EQ(h.pool_capacity(), capacity);
+}
+
+TEST(PairingHeapTest, MoveOnlyAndDestructors)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        PairingHeap<std::shared_ptr<int>> h;
+        for (int i = 0; i < 100; i++)
+            h.push(counter);
+        ASSERT_EQ(counter.use_count(), 101);
+        h.pop();
+        ASSERT_EQ(counter.use_count(), 100);
+        PairingHeap<std::shared_ptr<int>> moved(std::move(h));
+        ASSERT_TRUE(h.empty());
+        ASSERT_EQ(moved.size(), 99);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+
+    PairingHeap<std::unique_ptr<int>, std::function<bool(const std::unique_ptr<int> &,
+                                                         const std::unique_ptr<int> &)>>
+        h([](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) { return *a < *b; });
+    h.push(std::make_unique<int>(3));
+    h.push(std::make_unique<int>(1));
+    ASSERT_EQ(*h.top(), 1);
+}
+
+// Elements are (value, id) pairs, so that the handle of any live element can be found by its id
+TEST(PairingHeapTest, Random)
+{
+    typedef std::pair<int, int> Element;
+    std::mt19937 mt(3);
+    PairingHeap<Element> h;
+    std::set<Element> reference;
+    std::vector<PairingHeap<Element>::handle> handles;
+    std::vector<int> live;
+    for (int i = 0; i < 20000; i++)
+    {
+        int op = static_cast<int>(mt() % 4);
+        if (op < 2 || h.empty())
+        {
+            Element element(static_cast<int>(mt() % 100000), static_cast<int>(handles.size()));
+            live.push_back(element.second);
+            handles.push_back(h.push(element));
+            reference.insert(element);
+        }
+        else if (op == 2)
+        {
+            ASSERT_EQ(h.top(), *reference.begin());
+            live.erase(std::find(live.begin(), live.end(), h.top().second));
+            reference.erase(reference.begin());
+            h.pop();
+        }
+        else
+        {
+            int id = live[mt() % live.size()];
+            Element old = h.value(handles[id]);
+            Element decreased(old.first / 2, id);
+            h.decrease_key(handles[id], decreased);
+            reference.erase(old);
+            reference.insert(decreased);
+        }
+        ASSERT_EQ(h.size(), reference.size());
+    }
+    while (!h.empty())
+    {
+        ASSERT_EQ(h.top(), *reference.begin());
+        reference.erase(reference.begin());
+        h.pop();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,11 @@
 #include "priority_queue.hpp"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
 
 TEST(PriorityQ, Empty)
 {
@@ -248,6 +254,210 @@ TEST(PriorityQ, MiscOperations)
     ASSERT_EQ(pq.size(), 0);
 }
 
+template <typename PQ> void check_heap_order(PQ &pq, std::vector<int> values)
+{
+    for (int v : values)
+        pq.push(v);
+    ASSERT_EQ(pq.size(), values.size());
+    std::sort(values.begin(), values.end(), std::greater<int>());
+    for (int v : values)
+    {
+        ASSERT_EQ(pq.top(), v);
+        pq.pop();
+    }
+    ASSERT_TRUE(pq.empty());
+}
+
+TEST(PriorityQ, Arity)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 1000; i++)
+        values.push_back((i * 7919) % 1009 - 500);
+    PriorityQueue<int, std::vector<int>, std::less<int>, 4> four;
+    check_heap_order(four, values);
+    PriorityQueue<int, std::vector<int, CacheAlignedAllocator<int>>, std::less<int>, 8> eight;
+    check_heap_order(eight, values);
+    PriorityQueue<int, std::deque<int>, std::less<int>, 3> three;
+    check_heap_order(three, values);
+    ASSERT_EQ(eight.arity, 8);
+}
+
+TEST(PriorityQ, ArityMinHeap)
+{
+    PriorityQueue<int, std::vector<int>, std::greater<int>, 8> pq;
+    for (int i = 100; i > 0; i--)
+        pq.push(i);
+    for (int i = 1; i <= 100; i++)
+    {
+        ASSERT_EQ(pq.top(), i);
+        pq.pop();
+    }
+}
+
+TEST(PriorityQ, CacheAlignedAllocator)
+{
+    // The element at index 1, the first child of the root, starts a cache line
+    std::vector<int, CacheAlignedAllocator<int>> v(100);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(v.data() + 1) % 64, 0);
+    struct Line
+    {
+        char bytes[64];
+    };
+    std::vector<Line, CacheAlignedAllocator<Line>> lines(3);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(lines.data()) % 64, 0);
+}
+
+// No element is constructed other than the ones pushed, so T needs no default constructor
+TEST(PriorityQ, NoDefaultConstructor)
+{
+    struct Job
+    {
+        int priority;
+
+        explicit Job(int p) : priority(p) {}
+
+        bool operator<(const Job &other) const { return priority < other.priority; }
+    };
+    PriorityQueue<Job, std::vector<Job, CacheAlignedAllocator<Job>>, std::less<Job>, 4> pq;
+    for (int i = 0; i < 100; i++)
+        pq.emplace((i * 37) % 100);
+    std::vector<Job> jobs = {Job(5), Job(200), Job(-1)};
+    pq.push_range(jobs.begin(), jobs.end());
+    PriorityQueue<Job, std::deque<Job>> from_range(jobs.begin(), jobs.end());
+    ASSERT_EQ(from_range.top().priority, 200);
+    ASSERT_EQ(pq.size(), 103);
+    ASSERT_EQ(pq.top().priority, 200);
+    pq.pop();
+    for (int i = 99; i >= 0; i--)
+    {
+        ASSERT_EQ(pq.top().priority, i);
+        pq.pop();
+        if (i == 5)
+        {
+            ASSERT_EQ(pq.top().priority, 5);
+            pq.pop();
+        }
+    }
+    ASSERT_EQ(pq.top().priority, -1);
+}
+
+TEST(PriorityQ, RangeConstructor)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 1000; i++)
+        values.push_back((i * 7919) % 1009);
+    PriorityQueue<int> pq(values.begin(), values.end());
+    ASSERT_EQ(pq.size(), 1000);
+    std::sort(values.begin(), values.end(), std::greater<int>());
+    for (int v : values)
+    {
+        ASSERT_EQ(pq.top(), v);
+        pq.pop();
+    }
+
+    PriorityQueue<int, std::vector<int>, std::less<int>, 4> empty(values.end(), values.end());
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(PriorityQ, PushRange)
+{
+    PriorityQueue<int, std::vector<int>, std::less<int>, 4> pq;
+    std::vector<int> all;
+    // Small batches are pushed one by one, large ones rebuild the heap
+    for (int batch : {1, 3, 1000, 2, 50, 10000})
+    {
+        std::vector<int> values;
+        for (int i = 0; i < batch; i++)
+            values.push_back((i * 31 + batch) % 977);
+        pq.push_range(values.begin(), values.end());
+        all.insert(all.end(), values.begin(), values.end());
+        ASSERT_EQ(pq.size(), all.size());
+        ASSERT_EQ(pq.top(), *std::max_element(all.begin(), all.end()));
+    }
+    std::sort(all.begin(), all.end(), std::greater<int>());
+    for (int v : all)
+    {
+        ASSERT_EQ(pq.top(), v);
+        pq.pop();
+    }
+}
+
+TEST(PriorityQ, MoveOnly)
+{
+    PriorityQueue<std::unique_ptr<int>, std::vector<std::unique_ptr<int>>,
+                  std::function<bool(const std::unique_ptr<int> &, const std::unique_ptr<int> &)>>
+        pq([](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) { return *a < *b; });
+    for (int i = 0; i < 100; i++)
+        pq.push(std::make_unique<int>((i * 37) % 100));
+    pq.emplace(new int(1000));
+    ASSERT_EQ(*pq.top(), 1000);
+    pq.pop();
+    std::unique_ptr<int> top;
+    pq.pop(top);
+    ASSERT_EQ(*top, 99);
+    for (int i = 98; i >= 0; i--)
+    {
+        ASSERT_EQ(*pq.top(), i);
+        pq.pop();
+    }
+}
+
+// Counts its calls, to check that the comparator is stored instead of default constructed
+struct CountingLess
+{
+    int *calls;
+
+    bool operator()(int a, int b) const
+    {
+        ++*calls;
+        return a < b;
+    }
+};
+
+TEST(PriorityQ, StatefulComparator)
+{
+    int calls = 0;
+    PriorityQueue<int, std::vector<int>, CountingLess> pq(CountingLess{&calls});
+    pq.push(1);
+    pq.push(2);
+    pq.push(3);
+    ASSERT_EQ(pq.top(), 3);
+    ASSERT_GT(calls, 0);
+    ASSERT_EQ(pq.value_comp().calls, &calls);
+}
+
+TEST(PriorityQ, HeapifyIsLinear)
+{
+    int calls = 0;
+    std::vector<int> values(100000);
+    for (int i = 0; i < 100000; i++)
+        values[i] = i;
+    PriorityQueue<int, std::vector<int>, CountingLess> pq(values.begin(), values.end(),
+                                                         CountingLess{&calls});
+    ASSERT_EQ(pq.top(), 99999);
+    // Floyd's construction needs fewer than 2n comparisons, pushing ascending values needs n log n
+    ASSERT_LT(calls, 2 * 100000);
+}
+
+TEST(PriorityQ, ReplaceTop)
+{
+    PriorityQueue<int, std::vector<int>, std::less<int>, 4> pq;
+    for (int i = 0; i < 100; i++)
+        pq.push(i);
+    pq.replace_top(-1);
+    ASSERT_EQ(pq.size(), 100);
+    ASSERT_EQ(pq.top(), 98);
+    pq.replace_top(1000);
+    ASSERT_EQ(pq.top(), 1000);
+    pq.pop();
+    for (int i = 97; i >= 0; i--)
+    {
+        ASSERT_EQ(pq.top(), i);
+        pq.pop();
+    }
+    ASSERT_EQ(pq.top(), -1);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,112 @@
+#include "priority_queue.hpp"
+#include "radix_heap.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+TEST(RadixHeapTest, Empty)
+{
+    RadixHeap<uint32_t> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_TRUE(h.empty());
+}
+
+TEST(RadixHeapTest, PushPop)
+{
+    RadixHeap<uint32_t> h;
+    for (uint32_t value : {5u, 3u, 8u, 3u, 1u, 4000000000u, 0u})
+        h.push(value);
+    ASSERT_EQ(h.size(), 7);
+    std::vector<uint32_t> order;
+    while (!h.empty())
+    {
+        order.push_back(h.top());
+        h.pop();
+    }
+    std::vector<uint32_t> expected = {0, 1, 3, 3, 5, 8, 4000000000u};
+    ASSERT_EQ(order, expected);
+}
+
+TEST(RadixHeapTest, Monotone)
+{
+    RadixHeap<int> h;
+    h.push(10);
+    h.push(20);
+    ASSERT_EQ(h.top(), 10);
+    // Elements equal to the last top are allowed, smaller ones are not
+    h.push(10);
+    ASSERT_THROW(h.push(9), std::logic_error);
+    h.pop();
+    h.pop();
+    ASSERT_EQ(h.top(), 20);
+    ASSERT_THROW(h.push(15), std::logic_error);
+    h.clear();
+    ASSERT_TRUE(h.empty());
+    h.push(-5);
+    ASSERT_EQ(h.top(), -5);
+}
+
+TEST(RadixHeapTest, SignedAndExtremes)
+{
+    RadixHeap<int64_t> h;
+    std::vector<int64_t> values = {0, -1, 1, std::numeric_limits<int64_t>::max(),
+                                   std::numeric_limits<int64_t>::min(), -1000000000000LL, 42};
+    for (int64_t value : values)
+        h.push(value);
+    std::sort(values.begin(), values.end());
+    for (int64_t value : values)
+    {
+        ASSERT_EQ(h.top(), value);
+        h.pop();
+    }
+    ASSERT_TRUE(h.empty());
+
+    RadixHeap<uint8_t> small;
+    for (int i = 255; i >= 0; i--)
+        small.push(static_cast<uint8_t>(i));
+    for (int i = 0; i < 256; i++)
+    {
+        ASSERT_EQ(small.top(), i);
+        small.pop();
+    }
+}
+
+// The same simulation loop runs on either queue: every popped event schedules new events in the
+// future, so the workload is monotone
+template <typename Queue> std::vector<uint64_t> simulate(Queue &queue)
+{
+    std::mt19937_64 mt(7);
+    std::vector<uint64_t> order;
+    for (int i = 0; i < 100; i++)
+        queue.push(mt() % 1000);
+    while (!queue.empty() && order.size() < 50000)
+    {
+        uint64_t now = queue.top();
+        queue.pop();
+        order.push_back(now);
+        for (uint64_t k = 1 + mt() % 2; k > 0; k--)
+            queue.push(now + mt() % 5000);
+    }
+    return order;
+}
+
+TEST(RadixHeapTest, SameOrderAsPriorityQueue)
+{
+    RadixHeap<uint64_t> radix;
+    PriorityQueue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> heap;
+    auto radix_order = simulate(radix);
+    auto heap_order = simulate(heap);
+    ASSERT_EQ(radix_order.size(), 50000);
+    ASSERT_EQ(radix_order, heap_order);
+    ASSERT_EQ(radix.size(), heap.size());
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
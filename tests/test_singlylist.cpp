@@ -1,5 +1,7 @@
 #include "singlylist.hpp"
 #include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
 
 
 TEST(SinglyList, TestEmpty)
@@ -116,6 +118,92 @@ TEST(SinglyList, GetNthElement)
     ASSERT_EQ(sll.get_nth(4) ,  ++it);
 }
 
+TEST(SinglyList, PoolAllocator)
+{
+    PoolAllocator<int> pool(16);
+    SinglyLinkedList<int, PoolAllocator<int>> a(pool), b(pool);
+    for (int i = 0; i < 20; i++)
+    {
+        a.push_back(i);
+        b.push_front(i);
+    }
+    ASSERT_EQ(pool.resource().slab_count(), 3);
+    ASSERT_EQ(a.back(), 19);
+    ASSERT_EQ(*b.begin(), 19);
+    SinglyLinkedList<int, PoolAllocator<int>> copy(a);
+    ASSERT_EQ(copy.get_allocator(), pool);
+    ASSERT_EQ(copy.size(), 20);
+    ASSERT_EQ(pool.resource().slab_count(), 4);
+    // Freed nodes are reused
+    a.clear();
+    copy.clear();
+    for (int i = 0; i < 40; i++)
+        a.push_back(i);
+    ASSERT_EQ(pool.resource().slab_count(), 4);
+    SinglyLinkedList<int, PoolAllocator<int>> moved(std::move(a));
+    ASSERT_EQ(moved.size(), 40);
+    ASSERT_EQ(moved.back(), 39);
+}
+
+TEST(SinglyList, ArenaAllocator)
+{
+    SinglyLinkedList<std::string, ArenaAllocator<std::string>> strings;
+    for (int i = 0; i < 1000; i++)
+        strings.push_back(std::to_string(i));
+    ASSERT_EQ(strings.back(), "999");
+    strings.clear();
+    ASSERT_TRUE(strings.empty());
+
+    // The list is the only user of its arena, so clear() reuses the same blocks
+    SinglyLinkedList<long, ArenaAllocator<long>> list;
+    for (long i = 0; i < 10000; i++)
+        list.push_back(i);
+    size_t blocks = list.get_allocator().resource().block_count();
+    for (int round = 0; round < 10; round++)
+    {
+        list.clear();
+        for (long i = 0; i < 10000; i++)
+            list.push_front(i);
+    }
+    ASSERT_EQ(list.get_allocator().resource().block_count(), blocks);
+    ASSERT_EQ(*list.begin(), 9999);
+}
+
+// Throws when copied, if throws is set
+struct ThrowOnCopy
+{
+    int value;
+    bool throws;
+
+    ThrowOnCopy(int v, bool t) : value(v), throws(t) {}
+
+    ThrowOnCopy(const ThrowOnCopy &other) : value(other.value), throws(other.throws)
+    {
+        if (throws)
+            throw std::runtime_error("copy");
+    }
+};
+
+// The value is copy constructed into the node, and a node whose value fails to copy goes back to
+// the allocator. With one node per slab, a node which was not returned would take a new slab on
+// every attempt
+TEST(SinglyList, ThrowingCopyReturnsNode)
+{
+    PoolAllocator<ThrowOnCopy> pool(1);
+    SinglyLinkedList<ThrowOnCopy, PoolAllocator<ThrowOnCopy>> list(pool);
+    list.push_back(ThrowOnCopy(1, false));
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_THROW(list.push_back(ThrowOnCopy(i, true)), std::runtime_error);
+        ASSERT_THROW(list.push_front(ThrowOnCopy(i, true)), std::runtime_error);
+    }
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(pool.resource().slab_count(), 2);
+    list.push_back(ThrowOnCopy(2, false));
+    ASSERT_EQ(list.size(), 2);
+    ASSERT_EQ(pool.resource().slab_count(), 2);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,9 @@
 #include "stack.hpp"
 #include "gtest/gtest.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include<stack>
 TEST(Stack, Empty)
@@ -11,6 +15,148 @@ TEST(Stack, Empty)
     s.push(14);
 }
 
+TEST(Stack, SmallChunkedBuffer)
+{
+    Stack<int, SmallChunkedBuffer<int, 4, 8>> s;
+    ASSERT_TRUE(s.empty());
+    for (int i = 0; i < 100; i++)
+    {
+        s.push(i);
+        ASSERT_EQ(s.top(), i);
+    }
+    ASSERT_EQ(s.size(), 100);
+    for (int i = 99; i >= 0; i--)
+    {
+        ASSERT_EQ(s.top(), i);
+        s.pop();
+    }
+    ASSERT_TRUE(s.empty());
+}
+
+TEST(Stack, SmallChunkedBufferReusesChunks)
+{
+    SmallChunkedBuffer<std::string, 2, 4> buffer;
+    for (int i = 0; i < 2; i++)
+        buffer.push_back(std::to_string(i));
+    ASSERT_EQ(buffer.chunk_count(), 0);
+    for (int i = 2; i < 30; i++)
+        buffer.push_back(std::to_string(i));
+    ASSERT_EQ(buffer.chunk_count(), 7);
+    // Depth changing across chunk boundaries, as in a depth first search, allocates no chunk
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 25; i++)
+            buffer.pop_back();
+        ASSERT_EQ(buffer.back(), "4");
+        for (int i = 5; i < 30; i++)
+            buffer.emplace_back(std::to_string(i));
+        ASSERT_EQ(buffer.back(), "29");
+    }
+    ASSERT_EQ(buffer.chunk_count(), 7);
+    for (int i = 0; i < 20; i++)
+        buffer.pop_back();
+    buffer.shrink_to_fit();
+    ASSERT_EQ(buffer.chunk_count(), 2);
+    ASSERT_EQ(buffer.back(), "9");
+    buffer.clear();
+    ASSERT_TRUE(buffer.empty());
+    buffer.shrink_to_fit();
+    ASSERT_EQ(buffer.chunk_count(), 0);
+    buffer.push_back("a");
+    ASSERT_EQ(buffer.back(), "a");
+}
+
+TEST(Stack, SmallChunkedBufferCopyAndDestroy)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        SmallChunkedBuffer<std::shared_ptr<int>, 3, 5> buffer;
+        for (int i = 0; i < 20; i++)
+            buffer.push_back(counter);
+        SmallChunkedBuffer<std::shared_ptr<int>, 3, 5> copy(buffer);
+        ASSERT_EQ(copy.size(), 20);
+        ASSERT_EQ(counter.use_count(), 41);
+        copy.pop_back();
+        copy = buffer;
+        ASSERT_EQ(copy.size(), 20);
+        ASSERT_EQ(counter.use_count(), 41);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+// A constructor which throws when a new chunk is entered leaves the buffer as it was
+TEST(Stack, SmallChunkedBufferThrowingConstructor)
+{
+    struct Throwing
+    {
+        int value;
+
+        explicit Throwing(int v) : value(v)
+        {
+            if (v < 0)
+                throw std::runtime_error("negative");
+        }
+    };
+    SmallChunkedBuffer<Throwing, 2, 2> buffer;
+    for (int i = 0; i < 4; i++)
+    {
+        buffer.emplace_back(i);
+        if (i % 2)
+        {
+            ASSERT_THROW(buffer.emplace_back(-1), std::runtime_error);
+            ASSERT_EQ(buffer.size(), i + 1);
+            ASSERT_EQ(buffer.back().value, i);
+        }
+    }
+    for (int i = 3; i >= 0; i--)
+    {
+        ASSERT_EQ(buffer.back().value, i);
+        buffer.pop_back();
+    }
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(Stack, SmallChunkedBufferMove)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        SmallChunkedBuffer<std::shared_ptr<int>, 3, 5> buffer;
+        for (int i = 0; i < 20; i++)
+            buffer.push_back(std::make_shared<int>(i));
+        size_t chunks = buffer.chunk_count();
+        // The chunks are handed over, not copied
+        SmallChunkedBuffer<std::shared_ptr<int>, 3, 5> moved(std::move(buffer));
+        ASSERT_EQ(moved.size(), 20);
+        ASSERT_EQ(moved.chunk_count(), chunks);
+        ASSERT_TRUE(buffer.empty());
+        ASSERT_EQ(buffer.chunk_count(), 0);
+        for (int i = 19; i >= 10; i--)
+        {
+            ASSERT_EQ(*moved.back(), i);
+            moved.pop_back();
+        }
+        // Only inline elements, and a spare chunk
+        SmallChunkedBuffer<std::shared_ptr<int>, 3, 5> small;
+        small.push_back(counter);
+        small.push_back(small.back());
+        moved = std::move(small);
+        ASSERT_EQ(moved.size(), 2);
+        ASSERT_EQ(counter.use_count(), 3);
+        ASSERT_TRUE(small.empty());
+        small = std::move(moved);
+        ASSERT_EQ(small.size(), 2);
+        small.push_back(counter);
+        small.push_back(counter);
+        ASSERT_EQ(small.size(), 4);
+        ASSERT_EQ(counter.use_count(), 5);
+        Stack<std::shared_ptr<int>, SmallChunkedBuffer<std::shared_ptr<int>, 3, 5>> stack;
+        stack.push(counter);
+        auto other = std::move(stack);
+        ASSERT_EQ(other.top(), counter);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,133 @@
+#include "swiss_hashmap.hpp"
+#include "gtest/gtest.h"
+#include <string>
+
+// A hash function which sends every key to the same group
+struct ConstantHash
+{
+    size_t operator()(int) const { return 42; }
+};
+
+TEST(SwissHashMapTest, Empty)
+{
+    SwissHashMap<std::string, int> h;
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_EQ(h.load_factor(), 0);
+    ASSERT_EQ(h.find("Hello"), std::nullopt);
+    ASSERT_FALSE(h.contains("Hello"));
+    ASSERT_NEAR(h.max_load_factor(), h.DEFAULT_MAX_LOAD_FACTOR, 1e-5);
+}
+
+TEST(SwissHashMapTest, InsertAndRetrieveValues)
+{
+    SwissHashMap<std::string, int> h;
+    h.insert("Hello there", 58);
+    h.insert("Who are you?", 31);
+    h.insert("C++", 198339);
+    h.insert("XYZ", -88881);
+    ASSERT_EQ(h.size(), 4);
+    ASSERT_EQ(h.find("Hello there"), 58);
+    ASSERT_EQ(h.find("Who are you?"), 31);
+    ASSERT_EQ(h.find("C++"), 198339);
+    ASSERT_EQ(h.find("XYZ"), -88881);
+    ASSERT_EQ(h.find("Hello there "), std::nullopt);
+    ASSERT_EQ(h.find(""), std::nullopt);
+}
+
+TEST(SwissHashMapTest, LargeNumberOfValues)
+{
+    SwissHashMap<int, long long int> h;
+    for (int i = 0; i < 780000; i++)
+        h.insert(i, static_cast<long long int>(i) * i);
+    ASSERT_EQ(h.size(), 780000);
+    ASSERT_LE(h.load_factor(), h.max_load_factor());
+    for (int i = 0; i < 780000; i++)
+        ASSERT_EQ(h.find(i), static_cast<long long int>(i) * i);
+    for (int i = 780000; i < 790000; i++)
+        ASSERT_FALSE(h.contains(i));
+}
+
+TEST(SwissHashMapTest, UpdateOperation)
+{
+    SwissHashMap<int, long long int> h;
+    for (int i = 0; i < 5000; i++)
+        h.insert(i, static_cast<long long int>(i) * i);
+    for (int i = 0; i < 5000; i++)
+        h.insert(i, static_cast<long long int>(i) * i * i);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 5000; i++)
+        ASSERT_EQ(h.find(i), static_cast<long long int>(i) * i * i);
+}
+
+TEST(SwissHashMapTest, Erase)
+{
+    SwissHashMap<int, int> h;
+    for (int i = 0; i < 10000; i++)
+        h.insert(i, i);
+    for (int i = 0; i < 10000; i += 2)
+        h.erase(i);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(h.contains(i), i % 2 == 1);
+    // Erasing a key which does not exist does nothing
+    h.erase(-1);
+    h.erase(0);
+    ASSERT_EQ(h.size(), 5000);
+    for (int i = 0; i < 10000; i += 2)
+        h.insert(i, -i);
+    ASSERT_EQ(h.size(), 10000);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(h.find(i), i % 2 ? i : -i);
+}
+
+TEST(SwissHashMapTest, ChurnDoesNotGrowTheTable)
+{
+    SwissHashMap<int, int> h;
+    for (int i = 0; i < 1000; i++)
+        h.insert(i, i);
+    auto capacity = h.capacity();
+    // Keep the number of keys constant, the tombstones should be reclaimed
+    for (int i = 1000; i < 200000; i++)
+    {
+        h.erase(i - 1000);
+        h.insert(i, i);
+    }
+    ASSERT_EQ(h.size(), 1000);
+    ASSERT_LE(h.capacity(), 2 * capacity);
+    for (int i = 199000; i < 200000; i++)
+        ASSERT_EQ(h.find(i), i);
+}
+
+TEST(SwissHashMapTest, CollidingKeys)
+{
+    // All keys share h1 and h2, so lookups have to probe across several groups
+    SwissHashMap<int, int, ConstantHash> h;
+    for (int i = 0; i < 200; i++)
+        h.insert(i, i * 3);
+    ASSERT_EQ(h.size(), 200);
+    for (int i = 0; i < 200; i++)
+        ASSERT_EQ(h.find(i), i * 3);
+    for (int i = 0; i < 200; i += 3)
+        h.erase(i);
+    for (int i = 0; i < 200; i++)
+        ASSERT_EQ(h.contains(i), i % 3 != 0);
+    ASSERT_EQ(h.find(1000), std::nullopt);
+}
+
+TEST(SwissHashMapTest, Clear)
+{
+    SwissHashMap<std::string, std::string> h;
+    h.insert("Hello", "World");
+    h.insert("C+", "+");
+    h.clear();
+    ASSERT_EQ(h.size(), 0);
+    ASSERT_FALSE(h.contains("Hello"));
+    h.insert("Hello", "Again");
+    ASSERT_EQ(h.find("Hello"), "Again");
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
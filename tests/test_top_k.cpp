@@ -0,0 +1,114 @@
+#include "top_k.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(TopKTest, Empty)
+{
+    TopK<int, 10> top;
+    ASSERT_EQ(top.size(), 0);
+    ASSERT_TRUE(top.empty());
+    ASSERT_TRUE(top.sorted().empty());
+    ASSERT_EQ(top.capacity, 10);
+}
+
+TEST(TopKTest, Offer)
+{
+    TopK<int, 3> top;
+    ASSERT_TRUE(top.offer(5));
+    ASSERT_TRUE(top.offer(1));
+    ASSERT_TRUE(top.offer(3));
+    ASSERT_EQ(top.threshold(), 1);
+    ASSERT_FALSE(top.offer(0));
+    ASSERT_FALSE(top.offer(1));
+    ASSERT_TRUE(top.offer(4));
+    ASSERT_EQ(top.threshold(), 3);
+    ASSERT_EQ(top.size(), 3);
+    ASSERT_EQ(top.sorted(), (std::vector<int>{5, 4, 3}));
+    top.clear();
+    ASSERT_TRUE(top.empty());
+}
+
+TEST(TopKTest, Smallest)
+{
+    TopK<std::string, 2, std::greater<std::string>> top;
+    for (const char *word : {"pear", "apple", "fig", "banana", "kiwi"})
+        top.offer(word);
+    ASSERT_EQ(top.sorted(), (std::vector<std::string>{"apple", "banana"}));
+}
+
+// sorted() needs no default constructor and no copy assignment
+TEST(TopKTest, SortedWithoutDefaultConstructor)
+{
+    struct Score
+    {
+        int points;
+
+        explicit Score(int p) : points(p) {}
+        Score(const Score &) = default;
+        Score(Score &&) = default;
+        Score &operator=(const Score &) = delete;
+        Score &operator=(Score &&) = default;
+
+        bool operator<(const Score &other) const { return points < other.points; }
+    };
+    TopK<Score, 3> top;
+    for (int points : {4, 9, 1, 7, 3})
+        top.offer(Score(points));
+    std::vector<int> points;
+    for (const Score &score : top.sorted())
+        points.push_back(score.points);
+    ASSERT_EQ(points, (std::vector<int>{9, 7, 4}));
+}
+
+TEST(TopKTest, Batch)
+{
+    std::mt19937 mt(1);
+    std::vector<unsigned> values(100000);
+    for (auto &value : values)
+        value = static_cast<unsigned>(mt());
+    TopK<unsigned, 100> batch, one_by_one;
+    batch.offer(values.begin(), values.begin() + 50);
+    batch.offer(values.begin() + 50, values.end());
+    for (unsigned value : values)
+        one_by_one.offer(value);
+    std::sort(values.begin(), values.end(), std::greater<unsigned>());
+    values.resize(100);
+    ASSERT_EQ(batch.sorted(), values);
+    ASSERT_EQ(one_by_one.sorted(), values);
+}
+
+TEST(TopKTest, MergeThreads)
+{
+    const int number_of_threads = 4, per_thread = 50000;
+    std::vector<TopK<int, 1000>> partial(number_of_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < number_of_threads; t++)
+    {
+        threads.emplace_back(
+            [&partial, t]()
+            {
+                for (int i = t; i < number_of_threads * per_thread; i += number_of_threads)
+                    partial[t].offer(i);
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    TopK<int, 1000> total;
+    for (auto &top : partial)
+        total.merge(std::move(top));
+    auto result = total.sorted();
+    ASSERT_EQ(result.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(result[i], number_of_threads * per_thread - 1 - i);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}